@@ -17,6 +17,8 @@
 #include <iostream>
 using std::cout;
 using std::endl;
+#include <chrono>
+#include <cstddef>
 #include <functional>
 using std::function;
 #include <fstream>
@@ -26,29 +28,40 @@ using std::ifstream;
 using std::future;
 #include <iterator>
 using std::advance;
+#include <memory>
 #include <string>
 using std::string;
 #include <thread>
+#include <type_traits>
 #include <vector>
 using std::vector;
 
 #include "bfeattacks/Accumulator.h"
 using bfeattacks::Accumulator;
+#include "adt/Trie.h"
+#include "bfeattacks/DictionaryEncoding.h"
+#include "bfeattacks/FilterDictionary.h"
 #include "bfeattacks/FilterRequireExactly.h"
 #include "bfeattacks/FilterSize.h"
 #include "bfeattacks/SingleRecord.h"
 #include "bloomfilter/BloomFilter.h"
 using bloomfilter::BloomFilter;
+using bloomfilter::BloomFilterBlocked;
 using bloomfilter::BloomFilterStandard;
+using bloomfilter::FixedBloomFilter;
 #include "bloomfilter/HashSet.h"
 using bloomfilter::HashSetPair;
 #include "bloomfilter/InsertionPolicy.h"
+#include "concurrent/ThreadPool.h"
 using bloomfilter::InsertionTrigramWithSentinel;
 using bloomfilter::InsertionQuadgramWithSentinel;
 #include "bfeattacks/ParallelAccumulator.h"
+#include "graph/Estimate.h"
 #include "graph/Traversals.h"
+#include "stats/NGramModel.h"
 #include "util/ByteVector.h"
 using util::ByteVector::toByteVector;
+#include "util/MappedFile.h"
 #include "util/String.h"
 using util::stripNonAlpha;
 using util::toLowerCase;
@@ -57,9 +70,19 @@ using util::Timer;
 
 vector<string> loadAndFilter(string filename, function<string(string)> filter);
 
+template <typename BloomFilterType>
+int attack(const vector<string> &lines, const string &alphabet,
+           function<string(string)> filter, const unsigned m,
+           const unsigned k, const unsigned numThreads, const int argc,
+           const char **argv);
+
 int main(const int argc, const char **argv) {
   if (argc <= 1) {
-    cout << "Invalid usage. Pass filename as first argument." << endl;
+    cout << "Invalid usage. Pass filename as first argument. Optionally pass "
+            "the number of threads, an n-gram model, a dictionary, the "
+            "filter length m and number of hashes k, and a trie made by "
+            "buildDictionary. Pass - to skip the model, dictionary or trie."
+         << endl;
     return 0;
   }
 
@@ -77,6 +100,13 @@ int main(const int argc, const char **argv) {
 
   cout << "Using " << numThreads << " threads.\n";
 
+  unsigned m = 1000;
+  if (argc > 5)
+    m = static_cast<unsigned>(std::stoul(argv[5]));
+  unsigned k = 30;
+  if (argc > 6)
+    k = static_cast<unsigned>(std::stoul(argv[6]));
+
   string filename(argv[1]);
   Timer t;
   cout << "Will process file: '" << filename << "'\n";
@@ -87,29 +117,70 @@ int main(const int argc, const char **argv) {
 
   cout << "File loaded and filtered. " << lines.size() << " lines." << t << endl;
 
-  const vector<graph::Traversal> traversals = {
-    { graph::Traversal::depth_first_search, graph::Traversal::all_simple_paths,
-      graph::Traversal::all_edge_disjoint_paths }
-  };
-
   // Bigram
   typedef BloomFilterStandard BloomFilterType;
-  const unsigned n = 2;
+  // Blocked bigram, all of an n-gram's bits in one cache line aligned 512 bit
+  // block
+  //typedef BloomFilterBlocked BloomFilterType;
   // Trigram
   //typedef BloomFilter<HashSetPair, InsertionTrigramWithSentinel, true> BloomFilterType;
-  //const unsigned n = 3;
   // Quadgram
   //typedef BloomFilter<HashSetPair, InsertionQuadgramWithSentinel, true> BloomFilterType;
-  //const unsigned n = 4;
+
+  // Common bigram setups have m and k compiled in, anything else is generic
+  if (std::is_same<BloomFilterType, BloomFilterStandard>::value) {
+    if (m == 1000 && k == 30)
+      return attack<FixedBloomFilter<1000, 30> >(lines, alphabet, filter, m, k,
+                                                  numThreads, argc, argv);
+    if (m == 200 && k == 6)
+      return attack<FixedBloomFilter<200, 6> >(lines, alphabet, filter, m, k,
+                                                numThreads, argc, argv);
+  }
+
+  return attack<BloomFilterType>(lines, alphabet, filter, m, k, numThreads,
+                                 argc, argv);
+}
+
+template <typename BloomFilterType>
+int attack(const vector<string> &lines, const string &alphabet,
+           function<string(string)> filter, const unsigned m,
+           const unsigned k, const unsigned numThreads, const int argc,
+           const char **argv) {
+  Timer t;
+
+  // Whether to pick a strategy per word from an estimate of its search. Words
+  // it searches in full take the all_simple_paths found below, split across
+  // the pool, rather than enumerating them twice
+  const bool adaptive = true;
+  const vector<graph::Traversal> traversals = {
+    { graph::Traversal::depth_first_search, graph::Traversal::all_simple_paths,
+      graph::Traversal::all_edge_disjoint_paths,
+      graph::Traversal::all_covering_paths }
+  };
+  // Candidates of the traversals that are neither split across the pool nor
+  // reused by the adaptive run go straight into prefix sharing sets, without
+  // storing their paths
+  const vector<graph::Traversal> collected = {
+    { graph::Traversal::depth_first_search,
+      graph::Traversal::all_edge_disjoint_paths,
+      graph::Traversal::all_covering_paths }
+  };
+
+  // The n of the n-grams BloomFilterType inserts, set with it in main
+  const unsigned n = 2;
 
   const auto key1 = toByteVector("1111111111111111111111111111111111111111111111111111111111111111");
   const auto key2 = toByteVector("2222222222222222222222222222222222222222222222222222222222222222");
-  const unsigned m = 1000;
-  const unsigned k = 30;
 
-  auto BFBuilder = [m, k, key1, key2]() {
-    HashSetPair hs(k);
+  // The one hash set setup, shared by the records and the encoding timing
+  auto HashesBuilder = [k, key1, key2]() {
+    typename BloomFilterType::hash_set hs(k);
     hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+    return hs;
+  };
+
+  auto BFBuilder = [m, HashesBuilder]() {
+    auto hs = HashesBuilder();
     return bfeattacks::SingleRecord<BloomFilterType>(
         BloomFilterType(m, hs));
   };
@@ -117,6 +188,22 @@ int main(const int argc, const char **argv) {
   cout << "Using filter setup:\n" << BFBuilder() << "\n"
        << "Using alphabet: " << alphabet << endl;
 
+  // Encoding alone, to compare hash set and storage choices apart from the
+  // attack
+  {
+    auto hs = HashesBuilder();
+    std::size_t bits = 0;
+    t.start();
+    for (const string &line : lines) {
+      BloomFilterType bf(m, hs);
+      bf.insert(line);
+      bits += bf.count();
+    }
+    t.stop();
+    cout << "Encoded " << lines.size() << " lines, " << bits
+         << " bits set in total." << t << endl;
+  }
+
   // No Filter
   /*
   auto BFFilter = [](bfeattacks::SingleRecord<BloomFilterType> &) {};
@@ -141,9 +228,87 @@ int main(const int argc, const char **argv) {
   cout << "Using filter of only bfeattacks::filter_size" << endl;
   */
 
+  // Keep a few pathological words from stalling the run. Words running out
+  // are reported as truncated rather than correct or incorrect
+  graph::Budget budget;
+  budget.max_paths = 1000000;
+  budget.max_time = std::chrono::seconds(60);
+  cout << "Limiting each traversal to " << budget.max_paths << " paths and "
+       << std::chrono::duration_cast<std::chrono::seconds>(budget.max_time)
+              .count() << " seconds" << endl;
+
+  // The adaptive run records the estimate beside the actual cost to check the
+  // policy against
+  graph::Policy policy;
+  if (adaptive)
+    cout << "Adaptive policy: full search up to " << policy.max_full_nodes
+         << " estimated vertices, covering up to "
+         << policy.max_covering_nodes << ", length bounded up to "
+         << policy.max_bounded_nodes << endl;
+
+  // With an n-gram model as the third argument, also rank the most plausible
+  // candidates to see how soon the right one comes up
+  stats::NGramModel model;
+  const size_t rankedCount = 1000;
+  if (argc > 3 && string(argv[3]) != "-") {
+    ifstream modelFile(argv[3], std::ios::binary);
+    if (!model.read(modelFile)) {
+      cout << "Could not read n-gram model from '" << argv[3] << "'" << endl;
+      return 0;
+    }
+    cout << "Ranking the top " << rankedCount << " candidates by order "
+         << model.order() << " n-gram model '" << argv[3] << "'" << endl;
+  }
+
+  // With a dictionary as the fourth argument, also look each filter up in the
+  // encoding of the whole dictionary
+  std::unique_ptr<bfeattacks::DictionaryEncoding<BloomFilterType> > encoding;
+  if (argc > 4 && string(argv[4]) != "-") {
+    const vector<string> words = loadAndFilter(argv[4], filter);
+    concurrent::ThreadPoolSimple encodingPool(numThreads);
+    encoding.reset(new bfeattacks::DictionaryEncoding<BloomFilterType>(
+        words, [&BFBuilder]() { return BFBuilder().bf; }, encodingPool));
+    cout << "Encoded dictionary '" << argv[4] << "' of " << words.size()
+         << " words into " << encoding->size() << " distinct filters" << endl;
+  }
+
+  // With a trie from buildDictionary as the seventh argument, also search
+  // all_simple_paths pruned to the branches that start one of its words. The
+  // trie is used in place from the mapped file
+  std::unique_ptr<util::MappedFile> trieFile;
+  adt::Trie trie;
+  if (argc > 7 && string(argv[7]) != "-") {
+    trieFile.reset(new util::MappedFile(argv[7]));
+    if (!trieFile->is_open() ||
+        !trie.view(trieFile->data(), trieFile->size())) {
+      cout << "Could not read trie from '" << argv[7] << "'" << endl;
+      return 0;
+    }
+    cout << "Pruning all simple paths by trie '" << argv[7] << "' of "
+         << trie.size() << " words" << endl;
+  }
+
+  // The ranked search keeps a partial path per edge it examines, so also
+  // limit its edges to bound its memory
+  graph::Budget rankedBudget = budget;
+  rankedBudget.max_edges = 2000000;
+
+  function<void(bfeattacks::SingleRecord<BloomFilterType> &)> filterAndRank =
+      [&model, &encoding, &trie, rankedCount, rankedBudget, budget,
+       BFFilter](bfeattacks::SingleRecord<BloomFilterType> &rec) {
+        BFFilter(rec);
+        if (model.order() != 0)
+          rec.run_ranked(model, rankedCount, rankedBudget);
+        if (encoding)
+          encoding->lookup(rec);
+        if (trie.size() != 0)
+          bfeattacks::search_dictionary(rec, trie, budget);
+      };
+
   t.start();
   auto stats = bfeattacks::ParallelAccumulate<BloomFilterType>(
-      lines, BFBuilder, BFFilter, traversals, alphabet, 10, numThreads, cout, 0xFF);
+      lines, BFBuilder, filterAndRank, traversals, alphabet, 10, numThreads, cout, 0xFF,
+      2, budget, adaptive, policy, collected);
   t.stop();
 
   cout << "Complete. Total of " << lines.size() << " lines." << t << endl;
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cerr;
+using std::cout;
+using std::endl;
+#include <random>
+using std::mt19937_64;
+#include <string>
+#include <vector>
+using std::vector;
+
+#include "adt/BitTuple.h"
+using adt::BitTuple;
+#include "util/BitKernels.h"
+using util::BitKernel;
+#include "util/Timer.h"
+using util::Timer;
+
+namespace {
+// How BitTuple counted before the kernels: a word at a time, clearing the
+// lowest set bit until none are left
+size_t countKernighan(const vector<uint64_t> &words) {
+  size_t count = 0;
+  for (uint64_t word : words)
+    for (; word != 0; ++count)
+      word &= word - 1;
+  return count;
+}
+}
+
+int main(const int argc, const char **argv) {
+  if (argc <= 1) {
+    cout << "Invalid usage. Pass the number of bits in each tuple. Optionally "
+            "pass the number of repetitions of each operation."
+         << endl;
+    return 0;
+  }
+
+  const size_t bits = std::stoul(argv[1]);
+  size_t repetitions = 100000;
+  if (argc > 2)
+    repetitions = std::stoul(argv[2]);
+
+  if (bits == 0) {
+    cerr << "Tuples need at least one bit" << endl;
+    return 1;
+  }
+
+  // Two random tuples, with the same bits also kept as plain words
+  mt19937_64 rng(1);
+  const size_t numWords = (bits + 63) / 64;
+  vector<uint64_t> aWords(numWords), bWords(numWords), andWords(numWords);
+  BitTuple<uint64_t> a(bits), b(bits);
+  for (size_t w = 0; w < numWords; ++w) {
+    aWords[w] = rng();
+    bWords[w] = rng();
+    for (size_t i = w * 64; i < bits && i < (w + 1) * 64; ++i) {
+      if ((aWords[w] >> (i % 64)) & 1)
+        a.set(i);
+      if ((bWords[w] >> (i % 64)) & 1)
+        b.set(i);
+    }
+  }
+  // Drop the bits past the end so both agree
+  if (bits % 64 != 0) {
+    const uint64_t mask = (uint64_t(1) << (bits % 64)) - 1;
+    aWords.back() &= mask;
+    bWords.back() &= mask;
+  }
+  for (size_t w = 0; w < numWords; ++w)
+    andWords[w] = aWords[w] & bWords[w];
+
+  cout << "Counting " << bits << " bits " << repetitions << " times."
+       << endl;
+
+  // The sums are printed so the loops cannot be optimized away
+  Timer t;
+  size_t sum = 0;
+  t.start();
+  for (size_t r = 0; r < repetitions; ++r)
+    sum += countKernighan(aWords);
+  t.stop();
+  cout << "word loop count: " << sum / repetitions << t << endl;
+
+  sum = 0;
+  t.start();
+  for (size_t r = 0; r < repetitions; ++r) {
+    for (size_t w = 0; w < numWords; ++w)
+      andWords[w] = aWords[w] & bWords[w];
+    sum += countKernighan(andWords);
+  }
+  t.stop();
+  cout << "word loop count of and: " << sum / repetitions << t << endl;
+
+  const BitKernel original = util::bit_kernel();
+  for (const BitKernel kernel : { BitKernel::generic, BitKernel::popcnt,
+                                  BitKernel::avx2, BitKernel::avx512 }) {
+    if (!util::force_bit_kernel(kernel))
+      continue;
+
+    sum = 0;
+    t.start();
+    for (size_t r = 0; r < repetitions; ++r)
+      sum += a.count();
+    t.stop();
+    cout << kernel << " count: " << sum / repetitions << t << endl;
+
+    sum = 0;
+    t.start();
+    for (size_t r = 0; r < repetitions; ++r)
+      sum += (a & b).count();
+    t.stop();
+    cout << kernel << " (a & b).count(): " << sum / repetitions << t << endl;
+
+    sum = 0;
+    t.start();
+    for (size_t r = 0; r < repetitions; ++r)
+      sum += count_and(a, b);
+    t.stop();
+    cout << kernel << " count_and: " << sum / repetitions << t << endl;
+
+    sum = 0;
+    t.start();
+    for (size_t r = 0; r < repetitions; ++r)
+      sum += count_or(a, b);
+    t.stop();
+    cout << kernel << " count_or: " << sum / repetitions << t << endl;
+  }
+  util::force_bit_kernel(original);
+
+  return 0;
+}
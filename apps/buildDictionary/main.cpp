@@ -0,0 +1,85 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::getline;
+using std::ifstream;
+using std::ofstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "adt/Trie.h"
+#include "util/MappedFile.h"
+#include "util/String.h"
+using util::stripNonAlpha;
+using util::toLowerCase;
+#include "util/Timer.h"
+using util::Timer;
+
+int main(const int argc, const char **argv) {
+  if (argc <= 2) {
+    cout << "Invalid usage. Pass word list filename as first argument and "
+            "dictionary filename as second." << endl;
+    return 0;
+  }
+
+  const string wordsfilename(argv[1]);
+  const string dictionaryfilename(argv[2]);
+
+  // Namelike, matching attackStats
+  auto filter = [](string s) { return toLowerCase(stripNonAlpha(s)); };
+
+  Timer t;
+  cout << "Will process file: '" << wordsfilename << "'\n";
+
+  t.start();
+  ifstream input(wordsfilename);
+  vector<string> words;
+  for (string line; getline(input, line);) {
+    string word = filter(line);
+    if (!word.empty())
+      words.push_back(word);
+  }
+  const adt::Trie dictionary(words);
+  t.stop();
+
+  cout << "Built dictionary of " << dictionary.size() << " words in "
+       << dictionary.node_count() << " nodes." << t << endl;
+
+  {
+    ofstream output(dictionaryfilename, std::ios::binary);
+    dictionary.write(output);
+  }
+
+  // Make sure it can be used straight from the file
+  util::MappedFile mapped(dictionaryfilename);
+  adt::Trie check;
+  if (!mapped.is_open() || !check.view(mapped.data(), mapped.size()) ||
+      check.size() != dictionary.size()) {
+    cout << "Could not read back dictionary from: '" << dictionaryfilename
+         << "'" << endl;
+    return 0;
+  }
+
+  cout << "Dictionary written to: '" << dictionaryfilename << "'" << endl;
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::getline;
+using std::ifstream;
+using std::ofstream;
+#include <string>
+using std::string;
+
+#include "stats/NGramModel.h"
+#include "util/String.h"
+using util::stripNonAlpha;
+using util::toLowerCase;
+#include "util/Timer.h"
+using util::Timer;
+
+int main(const int argc, const char **argv) {
+  if (argc <= 2) {
+    cout << "Invalid usage. Pass corpus filename as first argument and model "
+            "filename as second. Optionally pass the order as third." << endl;
+    return 0;
+  }
+
+  const string corpusfilename(argv[1]);
+  const string modelfilename(argv[2]);
+  const unsigned long order = argc > 3 ? std::stoul(argv[3]) : 3;
+
+  // Namelike, matching attackStats
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+  auto filter = [](string s) { return toLowerCase(stripNonAlpha(s)); };
+
+  Timer t;
+  cout << "Building order " << order << " model from: '" << corpusfilename
+       << "'\n";
+
+  stats::NGramModel model(order, alphabet);
+  ifstream input(corpusfilename);
+  unsigned long words = 0;
+
+  t.start();
+  for (string line; getline(input, line);) {
+    const string word = filter(line);
+    if (word.empty())
+      continue;
+    model.add(word);
+    ++words;
+  }
+  t.stop();
+
+  cout << "Counted " << words << " words." << t << endl;
+
+  ofstream output(modelfilename, std::ios::binary);
+  model.write(output);
+  cout << "Model written to: '" << modelfilename << "'" << endl;
+
+  return 0;
+}
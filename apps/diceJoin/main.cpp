@@ -0,0 +1,134 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+using std::cerr;
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::getline;
+using std::ifstream;
+using std::ofstream;
+#include <string>
+using std::string;
+#include <thread>
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bfeattacks/DictionaryEncoding.h"
+#include "bloomfilter/FilterArray.h"
+using bloomfilter::FilterArray;
+#include "bloomfilter/SimilarityJoin.h"
+using bloomfilter::JoinPair;
+#include "concurrent/ThreadPool.h"
+#include "util/BitKernels.h"
+#include "util/Timer.h"
+using util::Timer;
+
+// Reads filters of m bits in hex, one per line, as written by
+// testSetGenerator. Returns false if a line is not one
+bool read_filters(const string &filename, const unsigned m,
+                  FilterArray &filters);
+
+bool read_filters(const string &filename, const unsigned m,
+                  FilterArray &filters) {
+  ifstream input(filename);
+  if (!input) {
+    cerr << "Failed to open " << filename << " for reading" << endl;
+    return false;
+  }
+
+  unsigned long line_number = 0;
+  boost::dynamic_bitset<> bits;
+  for (string line; getline(input, line);) {
+    ++line_number;
+    if (!bfeattacks::filter_from_hex(line, m, bits)) {
+      cerr << filename << ":" << line_number << ": not a " << m
+           << " bit filter in hex" << endl;
+      return false;
+    }
+    filters.add(bits);
+  }
+  return true;
+}
+
+int main(const int argc, const char **argv) {
+  if (argc <= 4) {
+    cout << "Invalid usage. Pass two files of filters in hex, one per line, "
+            "the file to write similar pairs to and the smallest Dice "
+            "coefficient to report. Optionally pass the number of best pairs "
+            "to keep per filter of the first file (0 for all) and the number "
+            "of threads."
+         << endl;
+    return 0;
+  }
+
+  bloomfilter::JoinOptions options;
+  options.threshold = std::stod(argv[4]);
+  if (argc > 5)
+    options.top_k = std::stoul(argv[5]);
+
+  unsigned numThreads = std::thread::hardware_concurrency();
+  if (argc > 6)
+    numThreads = static_cast<unsigned>(std::stoul(argv[6]));
+
+  if (options.threshold < 0 || options.threshold > 1) {
+    cerr << "The Dice coefficient must be between 0 and 1" << endl;
+    return 1;
+  }
+
+  // Matches testSetGenerator
+  const unsigned m = 1000;
+
+  cout << "Using " << numThreads << " threads and the "
+       << util::bit_kernel() << " kernel." << endl;
+
+  Timer t;
+  t.start();
+  FilterArray left(m), right(m);
+  if (!read_filters(argv[1], m, left) || !read_filters(argv[2], m, right))
+    return 1;
+  t.stop();
+  cout << "Read " << left.size() << " and " << right.size() << " filters."
+       << t << endl;
+
+  ofstream out(argv[3], std::ios::binary);
+  if (!out) {
+    cerr << "Failed to open " << argv[3] << " for writing" << endl;
+    return 1;
+  }
+
+  unsigned long pairs = 0;
+  t.start();
+  concurrent::ThreadPoolSimple pool(numThreads);
+  bloomfilter::write_join_header(out);
+  bloomfilter::dice_join(left, right, options, pool,
+                         [&out, &pairs](const vector<JoinPair> &found) {
+                           bloomfilter::write_join_pairs(out, found);
+                           pairs += found.size();
+                         });
+  t.stop();
+
+  cout << "Wrote " << pairs << " pairs with a Dice coefficient of at least "
+       << options.threshold;
+  if (options.top_k != 0)
+    cout << ", keeping the best " << options.top_k << " per filter";
+  cout << "." << t << endl;
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::getline;
+using std::ifstream;
+#include <string>
+using std::string;
+#include <thread>
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bfeattacks/DictionaryEncoding.h"
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "concurrent/ThreadPool.h"
+#include "util/ByteVector.h"
+using util::ByteVector::toByteVector;
+#include "util/String.h"
+using util::stripNonAlpha;
+using util::toLowerCase;
+#include "util/Timer.h"
+using util::Timer;
+
+int main(const int argc, const char **argv) {
+  if (argc <= 2) {
+    cout << "Invalid usage. Pass dictionary filename as first argument and "
+            "a file of target filters in hex, one per line, as second."
+         << endl;
+    return 0;
+  }
+
+  unsigned numThreads = std::thread::hardware_concurrency();
+  if (argc > 3)
+    numThreads = static_cast<unsigned>(std::stoul(argv[3]));
+
+  // Namelike, matching attackStats
+  auto filter = [](string s) { return toLowerCase(stripNonAlpha(s)); };
+
+  // Same setup as attackStats, keys included
+  typedef BloomFilterStandard BloomFilterType;
+  const auto key1 = toByteVector("1111111111111111111111111111111111111111111111111111111111111111");
+  const auto key2 = toByteVector("2222222222222222222222222222222222222222222222222222222222222222");
+  const unsigned m = 1000;
+  const unsigned k = 30;
+
+  auto BFBuilder = [m, k, key1, key2]() {
+    HashSetPair hs(k);
+    hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+    return BloomFilterType(m, hs);
+  };
+
+  cout << "Using " << numThreads << " threads.\n"
+       << "Using filter setup:\n" << BFBuilder() << endl;
+
+  Timer t;
+  t.start();
+  vector<string> words;
+  {
+    ifstream input(argv[1]);
+    for (string line; getline(input, line);) {
+      string word = filter(line);
+      if (!word.empty())
+        words.push_back(word);
+    }
+  }
+
+  concurrent::ThreadPoolSimple pool(numThreads);
+  const bfeattacks::DictionaryEncoding<BloomFilterType> encoding(
+      words, BFBuilder, pool);
+  t.stop();
+
+  cout << "Encoded " << words.size() << " words into " << encoding.size()
+       << " distinct filters." << t << endl;
+
+  unsigned long targets = 0;
+  unsigned long matched = 0;
+  unsigned long unique = 0;
+
+  t.start();
+  ifstream input(argv[2]);
+  for (string line; getline(input, line);) {
+    ++targets;
+    boost::dynamic_bitset<> bits;
+    if (!bfeattacks::filter_from_hex(line, m, bits)) {
+      cout << targets << ": not a " << m << " bit filter in hex\n";
+      continue;
+    }
+
+    const auto &found = encoding.lookup(bits);
+    cout << targets << ":";
+    for (const auto &w : found)
+      cout << " " << w;
+    cout << "\n";
+
+    if (!found.empty())
+      ++matched;
+    if (found.size() == 1)
+      ++unique;
+  }
+  t.stop();
+
+  cout << "Matched " << matched << " of " << targets << " targets, " << unique
+       << " to a single word." << t << endl;
+
+  return 0;
+}
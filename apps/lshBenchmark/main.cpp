@@ -0,0 +1,189 @@
+/*
+ * Copyright 2017 Will Mitchell
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+using std::min;
+#include <cstddef>
+using std::size_t;
+#include <iostream>
+using std::cerr;
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::ofstream;
+#include <future>
+using std::future;
+#include <random>
+using std::mt19937;
+using std::uniform_int_distribution;
+#include <string>
+using std::string;
+#include <thread>
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bloomfilter/BitSamplingIndex.h"
+using bloomfilter::BitSamplingIndex;
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/FilterArray.h"
+using bloomfilter::FilterArray;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "concurrent/ThreadPool.h"
+#include "util/BitKernels.h"
+#include "util/ByteVector.h"
+using util::ByteVector::toByteVector;
+#include "util/Timer.h"
+using util::Timer;
+#include "util/random/String.h"
+using util::random::uniformString;
+
+int main(const int argc, const char **argv) {
+  if (argc <= 1) {
+    cout << "Invalid usage. Pass the number of filters to index. Optionally "
+            "pass the bits sampled per table, the number of tables, the "
+            "smallest Dice coefficient to find, the number of threads and a "
+            "file to write the index to."
+         << endl;
+    return 0;
+  }
+
+  const size_t count = std::stoul(argv[1]);
+  BitSamplingIndex::Parameters parameters;
+  if (argc > 2)
+    parameters.bits = static_cast<unsigned>(std::stoul(argv[2]));
+  if (argc > 3)
+    parameters.tables = static_cast<unsigned>(std::stoul(argv[3]));
+  double threshold = 0.8;
+  if (argc > 4)
+    threshold = std::stod(argv[4]);
+  unsigned numThreads = std::thread::hardware_concurrency();
+  if (argc > 5)
+    numThreads = static_cast<unsigned>(std::stoul(argv[5]));
+
+  if (parameters.bits == 0 || parameters.bits > 64) {
+    cerr << "Between 1 and 64 bits can be sampled per table" << endl;
+    return 1;
+  }
+
+  // Same setup as testSetGenerator, with fixed keys
+  const auto key1 = toByteVector("1111111111111111111111111111111111111111111111111111111111111111");
+  const auto key2 = toByteVector("2222222222222222222222222222222222222222222222222222222222222222");
+  const unsigned m = 1000;
+  const unsigned k = 30;
+  auto encode = [m, k, key1, key2](const string &name) {
+    HashSetPair hs(k);
+    hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+    BloomFilterStandard bf(m, hs);
+    bf.insert(name);
+    return bf.raw();
+  };
+
+  // Random lower case names of 5 to 10 letters
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+  uniform_int_distribution<string::size_type> letter(0, alphabet.size() - 1);
+  uniform_int_distribution<unsigned> length(5, 10);
+  mt19937 rng(1);
+  vector<string> names;
+  names.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    names.push_back(uniformString(alphabet, length(rng), letter, rng));
+
+  cout << "Using " << numThreads << " threads and the " << util::bit_kernel()
+       << " kernel." << endl;
+  concurrent::ThreadPoolSimple pool(numThreads);
+
+  Timer t;
+  t.start();
+  FilterArray filters(m);
+  {
+    const size_t block_size = 4096;
+    vector<future<vector<boost::dynamic_bitset<> > > > blocks;
+    for (size_t start = 0; start < count; start += block_size) {
+      const size_t end = min(start + block_size, count);
+      blocks.push_back(pool.submit([&names, &encode, start, end]() {
+        vector<boost::dynamic_bitset<> > encoded;
+        for (size_t i = start; i < end; ++i)
+          encoded.push_back(encode(names[i]));
+        return encoded;
+      }));
+    }
+    for (auto &block : blocks)
+      for (const auto &bits : block.get())
+        filters.add(bits);
+  }
+  t.stop();
+  cout << "Encoded " << filters.size() << " filters." << t << endl;
+
+  t.start();
+  const BitSamplingIndex index(std::move(filters), parameters, pool);
+  t.stop();
+  cout << "Built " << parameters.tables << " tables sampling "
+       << parameters.bits << " bits." << t << endl;
+
+  if (argc > 6) {
+    t.start();
+    ofstream out(argv[6], std::ios::binary);
+    index.write(out);
+    t.stop();
+    cout << "Wrote index to " << argv[6] << "." << t << endl;
+  }
+
+  // Queries are indexed names with one letter changed, so each has at least
+  // one true match somewhere near the threshold
+  const size_t query_count = min<size_t>(1000, count);
+  uniform_int_distribution<size_t> pick(0, count - 1);
+  vector<boost::dynamic_bitset<> > queries;
+  for (size_t i = 0; i < query_count; ++i) {
+    string name = names[pick(rng)];
+    uniform_int_distribution<size_t> position(0, name.size() - 1);
+    name[position(rng)] = alphabet[letter(rng)];
+    queries.push_back(encode(name));
+  }
+
+  vector<vector<FilterArray::Hit> > found(query_count);
+  size_t candidates = 0;
+  t.start();
+  for (size_t i = 0; i < query_count; ++i)
+    candidates += index.query(queries[i], threshold, found[i]);
+  t.stop();
+  cout << "Answered " << query_count << " queries checking "
+       << static_cast<double>(candidates) / static_cast<double>(query_count)
+       << " candidates each." << t << endl;
+
+  // The exact scan is slow at scale, so compare recall on fewer queries
+  const size_t exact_count = min<size_t>(100, query_count);
+  size_t expected = 0, recalled = 0;
+  t.start();
+  for (size_t i = 0; i < exact_count; ++i) {
+    vector<FilterArray::Hit> exact;
+    index.filters().dice_at_least(queries[i], threshold, exact);
+    expected += exact.size();
+    recalled += found[i].size();
+  }
+  t.stop();
+  cout << "Scanned " << exact_count << " queries exactly." << t << "\n"
+       << "Recall at Dice >= " << threshold << ": " << recalled << " of "
+       << expected << " = "
+       << (expected == 0 ? 1.0 : static_cast<double>(recalled) /
+                                     static_cast<double>(expected))
+       << endl;
+
+  return 0;
+}
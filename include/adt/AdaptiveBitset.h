@@ -0,0 +1,298 @@
+//===-- adt/AdaptiveBitset.h - Sparse or dense bitset -----------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief AdaptiveBitset - a bitset kept as a sorted list of the positions set
+/// while few are, and as words once that would take more room
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_ADAPTIVEBITSET_H_INCLUDED
+#define ADT_ADAPTIVEBITSET_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "util/BitKernels.h"
+
+namespace adt {
+/// AdaptiveBitset - a fixed size bitset for very long, lightly filled Bloom
+/// filters
+///
+/// While it is sparse the bits set are a sorted array of 32-bit positions, so
+/// memory, count(), == and intersection counts scale with the bits set rather
+/// than the size. Once a position takes more room than the words would, that
+/// is past one bit in 32, it switches to words for good. It offers what
+/// BloomFilter needs of its storage, but has no words to give while sparse,
+/// so filters using it cannot go into a FilterArray.
+class AdaptiveBitset {
+public:
+  typedef std::size_t size_type;
+  typedef std::uint32_t position_type;
+
+  AdaptiveBitset() : bits(0), positions(), words() {}
+  explicit AdaptiveBitset(size_type bits_)
+      : bits(bits_), positions(), words() {
+    assert(bits_ <= size_type(UINT32_MAX) + 1 &&
+           "Positions must fit in 32 bits");
+  }
+
+  size_type size() const { return bits; }
+  /// Whether the bits are kept as positions rather than words
+  bool is_sparse() const { return words.empty(); }
+  /// Bits set past which a sparse bitset switches to words
+  size_type sparse_limit() const { return bits / 32; }
+
+  size_type count() const;
+  bool any() const { return count() != 0; }
+  bool none() const { return count() == 0; }
+
+  AdaptiveBitset &set(size_type i);
+  AdaptiveBitset &reset(size_type i);
+  bool test(size_type i) const;
+  bool operator[](size_type i) const { return test(i); }
+
+  /// Calls f with each position set, in increasing order
+  template <typename F> void for_each_set(F f) const;
+
+  /// Writes the size and the positions set, which read restores along with
+  /// the representation. Returns false on a stream error
+  bool write(std::ostream &out) const;
+  bool read(std::istream &in);
+
+  friend bool operator==(const AdaptiveBitset &lhs, const AdaptiveBitset &rhs);
+
+  /// Number of bits set in both, found from the positions of whichever is
+  /// sparse. Found by argument dependent lookup by BloomFilter
+  friend size_type intersection_count(const AdaptiveBitset &lhs,
+                                      const AdaptiveBitset &rhs);
+
+private:
+  void make_dense();
+
+  size_type bits;
+  // Sorted, while sparse
+  std::vector<position_type> positions;
+  // Once dense, and empty until then
+  std::vector<util::Word> words;
+};
+
+bool operator==(const AdaptiveBitset &lhs, const AdaptiveBitset &rhs);
+AdaptiveBitset::size_type intersection_count(const AdaptiveBitset &lhs,
+                                             const AdaptiveBitset &rhs);
+
+inline bool operator!=(const AdaptiveBitset &lhs, const AdaptiveBitset &rhs) {
+  return !(lhs == rhs);
+}
+
+/// bits as a boost::dynamic_bitset, set from its positions since it has no
+/// words to give while sparse. Found by argument dependent lookup alongside
+/// util::as_dynamic_bitset
+boost::dynamic_bitset<> as_dynamic_bitset(const AdaptiveBitset &bits);
+}
+
+inline adt::AdaptiveBitset::size_type adt::AdaptiveBitset::count() const {
+  if (words.empty())
+    return positions.size();
+  return util::count(words.data(), words.size());
+}
+
+inline adt::AdaptiveBitset &adt::AdaptiveBitset::set(size_type i) {
+  assert(i < bits && "Out-of-bounds bit access");
+  if (!words.empty()) {
+    words[i / 64] |= util::Word(1) << (i % 64);
+    return *this;
+  }
+
+  const position_type p = static_cast<position_type>(i);
+  const auto at = std::lower_bound(positions.begin(), positions.end(), p);
+  if (at != positions.end() && *at == p)
+    return *this;
+  positions.insert(at, p);
+
+  if (positions.size() > sparse_limit())
+    make_dense();
+  return *this;
+}
+
+inline adt::AdaptiveBitset &adt::AdaptiveBitset::reset(size_type i) {
+  assert(i < bits && "Out-of-bounds bit access");
+  if (!words.empty()) {
+    words[i / 64] &= ~(util::Word(1) << (i % 64));
+    return *this;
+  }
+
+  const position_type p = static_cast<position_type>(i);
+  const auto at = std::lower_bound(positions.begin(), positions.end(), p);
+  if (at != positions.end() && *at == p)
+    positions.erase(at);
+  return *this;
+}
+
+inline bool adt::AdaptiveBitset::test(size_type i) const {
+  assert(i < bits && "Out-of-bounds bit access");
+  if (!words.empty())
+    return ((words[i / 64] >> (i % 64)) & 1) != 0;
+  return std::binary_search(positions.begin(), positions.end(),
+                            static_cast<position_type>(i));
+}
+
+template <typename F> void adt::AdaptiveBitset::for_each_set(F f) const {
+  if (words.empty()) {
+    for (const position_type p : positions)
+      f(static_cast<size_type>(p));
+    return;
+  }
+
+  for (size_type w = 0; w < words.size(); ++w)
+    for (util::Word set = words[w]; set != 0; set &= set - 1)
+      f(w * 64 + static_cast<size_type>(__builtin_ctzll(set)));
+}
+
+inline bool adt::AdaptiveBitset::write(std::ostream &out) const {
+  const std::uint64_t header[2] = { bits, count() };
+  out.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  std::vector<position_type> set;
+  const std::vector<position_type> *list = &positions;
+  if (!words.empty()) {
+    set.reserve(count());
+    for_each_set([&set](size_type p) {
+      set.push_back(static_cast<position_type>(p));
+    });
+    list = &set;
+  }
+  out.write(reinterpret_cast<const char *>(list->data()),
+            static_cast<std::streamsize>(list->size() * sizeof(position_type)));
+  return static_cast<bool>(out);
+}
+
+inline bool adt::AdaptiveBitset::read(std::istream &in) {
+  std::uint64_t header[2];
+  if (!in.read(reinterpret_cast<char *>(header), sizeof(header)))
+    return false;
+  // Positions are 32 bits, and no more can be set than there are
+  if (header[0] > std::uint64_t(UINT32_MAX) + 1 || header[1] > header[0])
+    return false;
+
+  // Built aside so a bad position leaves *this as it was. The positions are
+  // read a block at a time, so a count claiming more than in holds doesn't
+  // allocate it all up front. write gives them in increasing order, which
+  // keeps each set an append
+  AdaptiveBitset result(static_cast<size_type>(header[0]));
+  std::vector<position_type> block(
+      static_cast<size_type>(std::min<std::uint64_t>(header[1], 1 << 16)));
+  // Least position the next may be
+  std::uint64_t next = 0;
+  for (std::uint64_t left = header[1]; left != 0;) {
+    const size_type n =
+        static_cast<size_type>(std::min<std::uint64_t>(left, block.size()));
+    if (!in.read(reinterpret_cast<char *>(block.data()),
+                 static_cast<std::streamsize>(n * sizeof(position_type))))
+      return false;
+    for (size_type i = 0; i < n; ++i) {
+      const position_type p = block[i];
+      if (p < next || p >= result.bits)
+        return false;
+      result.set(p);
+      next = std::uint64_t(p) + 1;
+    }
+    left -= n;
+  }
+  *this = std::move(result);
+  return true;
+}
+
+inline void adt::AdaptiveBitset::make_dense() {
+  words.assign((bits + 63) / 64, 0);
+  for (const position_type p : positions)
+    words[p / 64] |= util::Word(1) << (p % 64);
+  positions.clear();
+  positions.shrink_to_fit();
+}
+
+inline boost::dynamic_bitset<>
+adt::as_dynamic_bitset(const AdaptiveBitset &bits) {
+  boost::dynamic_bitset<> result(bits.size());
+  bits.for_each_set([&result](AdaptiveBitset::size_type p) { result.set(p); });
+  return result;
+}
+
+inline bool adt::operator==(const AdaptiveBitset &lhs,
+                            const AdaptiveBitset &rhs) {
+  if (lhs.bits != rhs.bits)
+    return false;
+  if (lhs.words.empty() && rhs.words.empty())
+    return lhs.positions == rhs.positions;
+  if (!lhs.words.empty() && !rhs.words.empty())
+    return lhs.words == rhs.words;
+
+  // One of each, so the same bits only if every sparse position is set in
+  // the dense one and it has no others
+  const AdaptiveBitset &sparse = lhs.words.empty() ? lhs : rhs;
+  const AdaptiveBitset &dense = lhs.words.empty() ? rhs : lhs;
+  if (sparse.count() != dense.count())
+    return false;
+  for (const AdaptiveBitset::position_type p : sparse.positions)
+    if (!dense.test(p))
+      return false;
+  return true;
+}
+
+inline adt::AdaptiveBitset::size_type
+adt::intersection_count(const AdaptiveBitset &lhs, const AdaptiveBitset &rhs) {
+  assert(lhs.bits == rhs.bits);
+  if (!lhs.words.empty() && !rhs.words.empty())
+    return util::count_and(lhs.words.data(), rhs.words.data(),
+                           lhs.words.size());
+
+  if (lhs.words.empty() && rhs.words.empty()) {
+    // Merge the sorted positions
+    AdaptiveBitset::size_type both = 0;
+    auto i = lhs.positions.begin(), j = rhs.positions.begin();
+    while (i != lhs.positions.end() && j != rhs.positions.end()) {
+      if (*i < *j) {
+        ++i;
+      } else if (*j < *i) {
+        ++j;
+      } else {
+        ++both;
+        ++i;
+        ++j;
+      }
+    }
+    return both;
+  }
+
+  const AdaptiveBitset &sparse = lhs.words.empty() ? lhs : rhs;
+  const AdaptiveBitset &dense = lhs.words.empty() ? rhs : lhs;
+  AdaptiveBitset::size_type both = 0;
+  for (const AdaptiveBitset::position_type p : sparse.positions)
+    both += dense.test(p);
+  return both;
+}
+
+#endif
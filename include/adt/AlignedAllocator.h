@@ -0,0 +1,85 @@
+//===-- adt/AlignedAllocator.h - Over-aligned allocator ---------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief AlignedAllocator - a standard allocator handing out memory aligned
+/// to more than operator new guarantees, such as to a cache line
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_ALIGNEDALLOCATOR_H_INCLUDED
+#define ADT_ALIGNEDALLOCATOR_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace adt {
+/// AlignedAllocator - allocates T aligned to Alignment bytes
+///
+/// Each allocation over-allocates by Alignment bytes, aligns within that and
+/// keeps the address operator new returned just before the aligned block.
+template <typename T, std::size_t Alignment> class AlignedAllocator {
+public:
+  static_assert(Alignment >= sizeof(void *) &&
+                    (Alignment & (Alignment - 1)) == 0,
+                "Alignment must be a power of two holding a pointer");
+
+  typedef T value_type;
+  template <typename U> struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T *allocate(std::size_t n);
+  void deallocate(T *p, std::size_t) noexcept;
+};
+
+template <typename T, typename U, std::size_t A>
+bool operator==(const AlignedAllocator<T, A> &, const AlignedAllocator<U, A> &) {
+  return true;
+}
+
+template <typename T, typename U, std::size_t A>
+bool operator!=(const AlignedAllocator<T, A> &, const AlignedAllocator<U, A> &) {
+  return false;
+}
+}
+
+template <typename T, std::size_t Alignment>
+T *adt::AlignedAllocator<T, Alignment>::allocate(std::size_t n) {
+  char *base = static_cast<char *>(::operator new(n * sizeof(T) + Alignment));
+  // At least one pointer's worth of room is left before the aligned address
+  const std::uintptr_t aligned =
+      (reinterpret_cast<std::uintptr_t>(base) + Alignment) & ~(Alignment - 1);
+  char *block = reinterpret_cast<char *>(aligned);
+  reinterpret_cast<void **>(block)[-1] = base;
+  return reinterpret_cast<T *>(block);
+}
+
+template <typename T, std::size_t Alignment>
+void adt::AlignedAllocator<T, Alignment>::deallocate(T *p,
+                                                     std::size_t) noexcept {
+  if (p)
+    ::operator delete(reinterpret_cast<void **>(p)[-1]);
+}
+
+#endif
@@ -0,0 +1,167 @@
+//===-- adt/AlignedBitset.h - Cache line aligned bitset ---------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief AlignedBitset - a fixed size bitset stored in whole, cache line
+/// aligned lines of 64-bit words, for use as Bloom filter storage
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_ALIGNEDBITSET_H_INCLUDED
+#define ADT_ALIGNEDBITSET_H_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "adt/AlignedAllocator.h"
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+namespace adt {
+/// AlignedBitset - a bitset whose words start on a 64 byte boundary and fill
+/// whole 64 byte lines
+///
+/// Bits past size() are always zero, so every operation works on whole words
+/// with no masking, and counts use the kernels in util/BitKernels.h. It
+/// offers the parts of boost::dynamic_bitset that BloomFilter uses, so it can
+/// be dropped in as its storage.
+class AlignedBitset {
+public:
+  typedef std::size_t size_type;
+  typedef util::Word block_type;
+
+  static const size_type line_words = 64 / sizeof(util::Word);
+
+  AlignedBitset() : bits(0), words() {}
+  explicit AlignedBitset(size_type bits_)
+      : bits(bits_),
+        words((bits_ + 64 * line_words - 1) / (64 * line_words) * line_words,
+              0) {}
+
+  size_type size() const { return bits; }
+  /// Number of words, including the padding to a whole line
+  size_type num_blocks() const { return words.size(); }
+  const util::Word *data() const { return words.data(); }
+
+  size_type count() const { return util::count(words.data(), words.size()); }
+  bool any() const;
+  bool none() const { return !any(); }
+
+  AlignedBitset &set(size_type i) {
+    assert(i < bits);
+    words[i / 64] |= util::Word(1) << (i % 64);
+    return *this;
+  }
+  AlignedBitset &reset(size_type i) {
+    assert(i < bits);
+    words[i / 64] &= ~(util::Word(1) << (i % 64));
+    return *this;
+  }
+  bool test(size_type i) const {
+    assert(i < bits);
+    return (words[i / 64] >> (i % 64)) & 1;
+  }
+  bool operator[](size_type i) const { return test(i); }
+
+  /// Sets every position in [first, last)
+  template <typename It> AlignedBitset &set_all(It first, It last);
+  /// Whether every position in [first, last) is set
+  template <typename It> bool test_all(It first, It last) const;
+
+  /// Intersection, union and symmetric difference with an equal sized bitset
+  AlignedBitset &operator&=(const AlignedBitset &rhs);
+  AlignedBitset &operator|=(const AlignedBitset &rhs);
+  AlignedBitset &operator^=(const AlignedBitset &rhs);
+
+  friend bool operator==(const AlignedBitset &lhs, const AlignedBitset &rhs) {
+    return lhs.bits == rhs.bits && lhs.words == rhs.words;
+  }
+
+private:
+  size_type bits;
+  std::vector<util::Word, AlignedAllocator<util::Word, 64> > words;
+};
+
+inline bool operator!=(const AlignedBitset &lhs, const AlignedBitset &rhs) {
+  return !(lhs == rhs);
+}
+
+inline AlignedBitset operator&(AlignedBitset lhs, const AlignedBitset &rhs) {
+  return lhs &= rhs;
+}
+
+inline AlignedBitset operator|(AlignedBitset lhs, const AlignedBitset &rhs) {
+  return lhs |= rhs;
+}
+
+/// The words of bits, found by argument dependent lookup alongside
+/// util::blocks for boost::dynamic_bitset
+inline util::BitsetBlocks blocks(const AlignedBitset &bits) {
+  return util::BitsetBlocks{ bits.data(), bits.num_blocks() };
+}
+}
+
+inline bool adt::AlignedBitset::any() const {
+  util::Word any = 0;
+  for (const util::Word w : words)
+    any |= w;
+  return any != 0;
+}
+
+template <typename It>
+adt::AlignedBitset &adt::AlignedBitset::set_all(It first, It last) {
+  for (; first != last; ++first)
+    set(static_cast<size_type>(*first));
+  return *this;
+}
+
+template <typename It>
+bool adt::AlignedBitset::test_all(It first, It last) const {
+  for (; first != last; ++first)
+    if (!test(static_cast<size_type>(*first)))
+      return false;
+  return true;
+}
+
+// The loops below are over whole, aligned lines, so compilers vectorize them
+inline adt::AlignedBitset &adt::AlignedBitset::
+operator&=(const AlignedBitset &rhs) {
+  assert(bits == rhs.bits);
+  for (size_type i = 0; i < words.size(); ++i)
+    words[i] &= rhs.words[i];
+  return *this;
+}
+
+inline adt::AlignedBitset &adt::AlignedBitset::
+operator|=(const AlignedBitset &rhs) {
+  assert(bits == rhs.bits);
+  for (size_type i = 0; i < words.size(); ++i)
+    words[i] |= rhs.words[i];
+  return *this;
+}
+
+inline adt::AlignedBitset &adt::AlignedBitset::
+operator^=(const AlignedBitset &rhs) {
+  assert(bits == rhs.bits);
+  for (size_type i = 0; i < words.size(); ++i)
+    words[i] ^= rhs.words[i];
+  return *this;
+}
+
+#endif
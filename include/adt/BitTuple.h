@@ -48,6 +48,7 @@
 #include <type_traits>
 
 #include "common/BitTwiddle.h"
+#include "util/BitKernels.h"
 
 namespace adt {
 /// BitTuple - n-tuple of bits, packed, with optimizations for small sizes
@@ -64,6 +65,12 @@ public:
   template <typename S>
   friend
   bool operator==(const BitTuple<S> &lhs, const BitTuple<S> &rhs);
+  template <typename S>
+  friend typename BitTuple<S>::size_type count_and(const BitTuple<S> &lhs,
+                                                   const BitTuple<S> &rhs);
+  template <typename S>
+  friend typename BitTuple<S>::size_type count_or(const BitTuple<S> &lhs,
+                                                  const BitTuple<S> &rhs);
 
   typedef size_t size_type;
 
@@ -234,6 +241,18 @@ BitTuple<Storage> operator-(const BitTuple<Storage> &lhs,
 template <typename Storage>
 BitTuple<Storage> operator^(const BitTuple<Storage> &lhs,
                             const BitTuple<Storage> &rhs) __attribute__((pure));
+
+/// population count of the intersection, without building it
+template <typename Storage>
+typename BitTuple<Storage>::size_type
+count_and(const BitTuple<Storage> &lhs,
+          const BitTuple<Storage> &rhs) __attribute__((pure));
+
+/// population count of the union, without building it
+template <typename Storage>
+typename BitTuple<Storage>::size_type
+count_or(const BitTuple<Storage> &lhs,
+         const BitTuple<Storage> &rhs) __attribute__((pure));
 } // namespace adt
 
 namespace std {
@@ -246,6 +265,48 @@ void swap(adt::BitTuple<Storage> &lhs, adt::BitTuple<Storage> &rhs) {
 // Implementation
 //------------------------------------------------------------------------------
 namespace adt {
+namespace detail {
+// Population counts over the large mode arrays. Arrays of 64-bit words use
+// the kernels in util/BitKernels.h, chosen for the processor at run time
+template <typename Storage>
+size_t countWords(const Storage *a, size_t n) {
+  size_t pop = 0;
+  for (size_t i = 0; i < n; ++i)
+    pop += common::popCount(a[i]);
+  return pop;
+}
+
+inline size_t countWords(const util::Word *a, size_t n) {
+  return util::count(a, n);
+}
+
+template <typename Storage>
+size_t countAndWords(const Storage *a, const Storage *b, size_t n) {
+  size_t pop = 0;
+  for (size_t i = 0; i < n; ++i)
+    pop += common::popCount(static_cast<Storage>(a[i] & b[i]));
+  return pop;
+}
+
+inline size_t countAndWords(const util::Word *a, const util::Word *b,
+                            size_t n) {
+  return util::count_and(a, b, n);
+}
+
+template <typename Storage>
+size_t countOrWords(const Storage *a, const Storage *b, size_t n) {
+  size_t pop = 0;
+  for (size_t i = 0; i < n; ++i)
+    pop += common::popCount(static_cast<Storage>(a[i] | b[i]));
+  return pop;
+}
+
+inline size_t countOrWords(const util::Word *a, const util::Word *b,
+                           size_t n) {
+  return util::count_or(a, b, n);
+}
+} // namespace detail
+
 // create empty small
 template <typename Storage> BitTuple<Storage>::BitTuple() : X(1) {}
 
@@ -297,12 +358,8 @@ typename BitTuple<Storage>::size_type BitTuple<Storage>::count() const {
   if (isSmall())
     return common::popCount(getSmallBits());
 
-  size_type pop = 0;
-  const size_type arrayLen = static_cast<size_type>(getPointer()[0]);
-  for (size_t i = 2; i < arrayLen; ++i)
-    pop += common::popCount(getPointer()[i]);
-
-  return pop;
+  return detail::countWords(getPointer() + 2,
+                            static_cast<size_type>(getPointer()[0]) - 2);
 }
 
 /// returns true if any bit is set
@@ -311,14 +368,15 @@ bool BitTuple<Storage>::any() const {
   if (isSmall())
     return getSmallBits() > 0;
 
-  // Large
-  const size_type arrayLen = static_cast<size_type>(getPointer()[0]);
-  for (size_t i = 2; i < arrayLen; ++i) {
-    if (getPointer()[i] > 0)
-      return true;
-  }
+  // Large. Or everything together rather than branching on each word, so
+  // the loop vectorizes
+  const Storage *words = getPointer() + 2;
+  const size_type len = static_cast<size_type>(getPointer()[0]) - 2;
+  Storage bits = 0;
+  for (size_t i = 0; i < len; ++i)
+    bits |= words[i];
 
-  return false;
+  return bits != 0;
 }
 
 /// return true is all bits are set
@@ -334,10 +392,11 @@ bool BitTuple<Storage>::all() const {
   // for common subexpression usage
   const size_type arrayLen = static_cast<size_type>(getPointer()[0]) - 1;
   Storage mask = static_cast<Storage>(~static_cast<Storage>(0));
-  for (size_t i = 2; i < arrayLen; ++i) {
-    if ((getPointer()[i] & mask) != mask)
-      return false;
-  }
+  Storage bits = mask;
+  for (size_t i = 2; i < arrayLen; ++i)
+    bits &= getPointer()[i];
+  if (bits != mask)
+    return false;
   // num bits stored is even multiple so last Storage is fully used
   const Storage remainder = getPointer()[1] % NumStorageBits;
   if (remainder == 0)
@@ -725,9 +784,15 @@ BitTuple<Storage> &BitTuple<Storage>::operator&=(const BitTuple<Storage> &rhs) {
     setSmallBits(getSmallBits() & rhs.getSmallBits());
     return *this;
   }
+  if (this == &rhs)
+    return *this;
 
-  for (Storage i = 2, e = getPointer()[0]; i < e; ++i)
-    getPointer()[i] &= rhs.getPointer()[i];
+  // The arrays are distinct, so let the compiler vectorize
+  Storage *__restrict lhsWords = getPointer() + 2;
+  const Storage *__restrict rhsWords = rhs.getPointer() + 2;
+  for (size_t i = 0, e = static_cast<size_t>(getPointer()[0]) - 2; i < e;
+       ++i)
+    lhsWords[i] &= rhsWords[i];
 
   return *this;
 }
@@ -743,9 +808,14 @@ BitTuple<Storage> &BitTuple<Storage>::reset(const BitTuple<Storage> &rhs) {
     setSmallBits(getSmallBits() & ~rhs.getSmallBits());
     return *this;
   }
+  if (this == &rhs)
+    return reset();
 
-  for (Storage i = 2, e = getPointer()[0]; i < e; ++i)
-    getPointer()[i] &= static_cast<Storage>(~rhs.getPointer()[i]);
+  Storage *__restrict lhsWords = getPointer() + 2;
+  const Storage *__restrict rhsWords = rhs.getPointer() + 2;
+  for (size_t i = 0, e = static_cast<size_t>(getPointer()[0]) - 2; i < e;
+       ++i)
+    lhsWords[i] &= static_cast<Storage>(~rhsWords[i]);
 
   return *this;
 }
@@ -782,9 +852,14 @@ BitTuple<Storage> &BitTuple<Storage>::operator|=(const BitTuple<Storage> &rhs) {
     setSmallBits(getSmallBits() | rhs.getSmallBits());
     return *this;
   }
+  if (this == &rhs)
+    return *this;
 
-  for (Storage i = 2, e = getPointer()[0]; i < e; ++i)
-    getPointer()[i] |= rhs.getPointer()[i];
+  Storage *__restrict lhsWords = getPointer() + 2;
+  const Storage *__restrict rhsWords = rhs.getPointer() + 2;
+  for (size_t i = 0, e = static_cast<size_t>(getPointer()[0]) - 2; i < e;
+       ++i)
+    lhsWords[i] |= rhsWords[i];
 
   return *this;
 }
@@ -799,9 +874,14 @@ BitTuple<Storage> &BitTuple<Storage>::operator^=(const BitTuple<Storage> &rhs) {
     setSmallBits(getSmallBits() ^ rhs.getSmallBits());
     return *this;
   }
+  if (this == &rhs)
+    return reset();
 
-  for (Storage i = 2, e = getPointer()[0]; i < e; ++i)
-    getPointer()[i] ^= rhs.getPointer()[i];
+  Storage *__restrict lhsWords = getPointer() + 2;
+  const Storage *__restrict rhsWords = rhs.getPointer() + 2;
+  for (size_t i = 0, e = static_cast<size_t>(getPointer()[0]) - 2; i < e;
+       ++i)
+    lhsWords[i] ^= rhsWords[i];
 
   return *this;
 }
@@ -996,5 +1076,33 @@ BitTuple<Storage> operator^(const BitTuple<Storage> &lhs,
   res ^= rhs;
   return res;
 }
+
+// population count of the intersection
+template <typename Storage>
+typename BitTuple<Storage>::size_type count_and(const BitTuple<Storage> &lhs,
+                                                const BitTuple<Storage> &rhs) {
+  assert(lhs.size() == rhs.size() &&
+         "Cannot count intersection unless size (universe) is the same");
+
+  if (lhs.isSmall())
+    return common::popCount(lhs.getSmallBits() & rhs.getSmallBits());
+
+  return detail::countAndWords(lhs.getPointer() + 2, rhs.getPointer() + 2,
+                               static_cast<size_t>(lhs.getPointer()[0]) - 2);
+}
+
+// population count of the union
+template <typename Storage>
+typename BitTuple<Storage>::size_type count_or(const BitTuple<Storage> &lhs,
+                                               const BitTuple<Storage> &rhs) {
+  assert(lhs.size() == rhs.size() &&
+         "Cannot count union unless size (universe) is the same");
+
+  if (lhs.isSmall())
+    return common::popCount(lhs.getSmallBits() | rhs.getSmallBits());
+
+  return detail::countOrWords(lhs.getPointer() + 2, rhs.getPointer() + 2,
+                              static_cast<size_t>(lhs.getPointer()[0]) - 2);
+}
 } // namespace adt
 #endif
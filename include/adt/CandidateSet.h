@@ -0,0 +1,152 @@
+//===-- adt/CandidateSet.h - Prefix sharing set of strings ------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief CandidateSet - a growable set of strings sharing storage between
+/// common prefixes, remembering the order strings were first inserted in
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_CANDIDATESET_H_INCLUDED
+#define ADT_CANDIDATESET_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace adt {
+/// CandidateSet - a growable set of strings sharing common prefixes
+///
+/// Each node holds one character and links to its parent, first child and
+/// next sibling, so a string costs one node per character not shared with an
+/// earlier one. Lookups walk at most one sibling list per character. The set
+/// can be large, so it can be moved but not copied.
+class CandidateSet {
+public:
+  CandidateSet() : nodes{ { none, none, none, '\0', false } } {}
+
+  CandidateSet(CandidateSet &&) = default;
+  CandidateSet &operator=(CandidateSet &&) = default;
+  CandidateSet(const CandidateSet &) = delete;
+  CandidateSet &operator=(const CandidateSet &) = delete;
+
+  /// Adds word, returning false if it was already present
+  bool insert(const std::string &word);
+  bool contains(const std::string &word) const;
+
+  /// Number of strings held
+  std::size_t size() const { return words.size(); }
+  bool empty() const { return words.empty(); }
+  /// Number of characters stored, plus one for the root
+  std::size_t node_count() const { return nodes.size(); }
+
+  /// The i-th distinct string inserted
+  std::string operator[](std::size_t i) const;
+  /// Every string in the order inserted
+  std::vector<std::string> to_vector() const;
+
+  void clear() { *this = CandidateSet(); }
+  /// Keeps only the strings keep returns true for, in the same order
+  template <typename F> void retain(F keep);
+
+private:
+  typedef std::uint32_t Node;
+  static const Node none = static_cast<Node>(-1);
+
+  struct NodeRecord {
+    Node parent;
+    Node first_child;
+    Node next_sibling;
+    char label;
+    bool terminal;
+  };
+
+  std::vector<NodeRecord> nodes;
+  // The node each string ends at, in the order inserted
+  std::vector<Node> words;
+
+  Node child(Node n, char c) const;
+};
+}
+
+inline adt::CandidateSet::Node adt::CandidateSet::child(Node n, char c) const {
+  for (Node i = nodes[n].first_child; i != none; i = nodes[i].next_sibling)
+    if (nodes[i].label == c)
+      return i;
+  return none;
+}
+
+inline bool adt::CandidateSet::insert(const std::string &word) {
+  Node n = 0;
+  for (const char c : word) {
+    Node next = child(n, c);
+    if (next == none) {
+      next = static_cast<Node>(nodes.size());
+      nodes.push_back({ n, none, nodes[n].first_child, c, false });
+      nodes[n].first_child = next;
+    }
+    n = next;
+  }
+
+  if (nodes[n].terminal)
+    return false;
+  nodes[n].terminal = true;
+  words.push_back(n);
+  return true;
+}
+
+inline bool adt::CandidateSet::contains(const std::string &word) const {
+  Node n = 0;
+  for (const char c : word) {
+    n = child(n, c);
+    if (n == none)
+      return false;
+  }
+  return nodes[n].terminal;
+}
+
+inline std::string adt::CandidateSet::operator[](std::size_t i) const {
+  std::string word;
+  for (Node n = words[i]; n != 0; n = nodes[n].parent)
+    word += nodes[n].label;
+  std::reverse(word.begin(), word.end());
+  return word;
+}
+
+template <typename F> void adt::CandidateSet::retain(F keep) {
+  CandidateSet kept;
+  for (std::size_t i = 0; i < words.size(); ++i) {
+    const std::string word = (*this)[i];
+    if (keep(word))
+      kept.insert(word);
+  }
+  *this = std::move(kept);
+}
+
+inline std::vector<std::string> adt::CandidateSet::to_vector() const {
+  std::vector<std::string> all;
+  all.reserve(words.size());
+  for (std::size_t i = 0; i < words.size(); ++i)
+    all.push_back((*this)[i]);
+  return all;
+}
+
+#endif
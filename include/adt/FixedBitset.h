@@ -0,0 +1,134 @@
+//===-- adt/FixedBitset.h - Bitset of compile time size ---------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief FixedBitset - a bitset whose size is a template parameter, held in
+/// a std::array of 64-bit words
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_FIXEDBITSET_H_INCLUDED
+#define ADT_FIXEDBITSET_H_INCLUDED
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+namespace adt {
+/// FixedBitset - Bits bits in the object itself
+///
+/// Word counts and indices are constants, so loops over the words have known
+/// trip counts. Bits past Bits are always zero. It offers what BloomFilter
+/// needs of its storage, taking the size in its constructor only to check it.
+template <std::size_t Bits> class FixedBitset {
+public:
+  static_assert(Bits > 0, "Need at least one bit");
+
+  typedef std::size_t size_type;
+  typedef util::Word block_type;
+
+  static const size_type num_words = (Bits + 63) / 64;
+
+  FixedBitset() : words() {}
+  explicit FixedBitset(size_type bits) : words() {
+    assert(bits == Bits && "Size is fixed at compile time");
+    (void)bits;
+  }
+
+  constexpr size_type size() const { return Bits; }
+  constexpr size_type num_blocks() const { return num_words; }
+  const util::Word *data() const { return words.data(); }
+
+  size_type count() const { return util::count(words.data(), num_words); }
+  bool any() const {
+    util::Word bits = 0;
+    for (const util::Word w : words)
+      bits |= w;
+    return bits != 0;
+  }
+  bool none() const { return !any(); }
+
+  FixedBitset &set(size_type i) {
+    assert(i < Bits && "Out-of-bounds bit access");
+    words[i / 64] |= util::Word(1) << (i % 64);
+    return *this;
+  }
+  FixedBitset &reset(size_type i) {
+    assert(i < Bits && "Out-of-bounds bit access");
+    words[i / 64] &= ~(util::Word(1) << (i % 64));
+    return *this;
+  }
+  bool test(size_type i) const {
+    assert(i < Bits && "Out-of-bounds bit access");
+    return ((words[i / 64] >> (i % 64)) & 1) != 0;
+  }
+  bool operator[](size_type i) const { return test(i); }
+
+  FixedBitset &operator&=(const FixedBitset &rhs) {
+    for (size_type i = 0; i < num_words; ++i)
+      words[i] &= rhs.words[i];
+    return *this;
+  }
+  FixedBitset &operator|=(const FixedBitset &rhs) {
+    for (size_type i = 0; i < num_words; ++i)
+      words[i] |= rhs.words[i];
+    return *this;
+  }
+  FixedBitset &operator^=(const FixedBitset &rhs) {
+    for (size_type i = 0; i < num_words; ++i)
+      words[i] ^= rhs.words[i];
+    return *this;
+  }
+
+  friend bool operator==(const FixedBitset &lhs, const FixedBitset &rhs) {
+    return lhs.words == rhs.words;
+  }
+  friend bool operator!=(const FixedBitset &lhs, const FixedBitset &rhs) {
+    return lhs.words != rhs.words;
+  }
+
+private:
+  std::array<util::Word, num_words> words;
+};
+
+template <std::size_t Bits> const std::size_t FixedBitset<Bits>::num_words;
+
+template <std::size_t Bits>
+FixedBitset<Bits> operator&(FixedBitset<Bits> lhs,
+                            const FixedBitset<Bits> &rhs) {
+  return lhs &= rhs;
+}
+
+template <std::size_t Bits>
+FixedBitset<Bits> operator|(FixedBitset<Bits> lhs,
+                            const FixedBitset<Bits> &rhs) {
+  return lhs |= rhs;
+}
+
+/// The words of bits, found by argument dependent lookup alongside
+/// util::blocks for boost::dynamic_bitset
+template <std::size_t Bits>
+util::BitsetBlocks blocks(const FixedBitset<Bits> &bits) {
+  return util::BitsetBlocks{ bits.data(), bits.num_blocks() };
+}
+}
+
+#endif
@@ -0,0 +1,379 @@
+//===-- adt/InlineBitTuple.h - Bit tuple with inline words ------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief InlineBitTuple - n-tuple of bits, packed, holding up to a fixed
+/// number of words without allocating
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_INLINEBITTUPLE_H_INCLUDED
+#define ADT_INLINEBITTUPLE_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "common/BitTwiddle.h"
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+namespace adt {
+/// InlineBitTuple - n-tuple of bits, with up to InlineWords words inline
+///
+/// This is to BitTuple what llvm::SmallVector is to std::vector. Tuples of up
+/// to InlineWords * 64 bits keep their words in the object itself, so a
+/// Bloom filter of a few hundred bits costs no allocation or pointer chase.
+/// Larger tuples spill to the heap. Bits past size() are always zero, so
+/// counts and comparisons work on whole words. It offers what BloomFilter
+/// needs of its storage.
+template <std::size_t InlineWords = 16> class InlineBitTuple {
+public:
+  static_assert(InlineWords > 0, "Need room for at least one word inline");
+
+  template <std::size_t N>
+  friend bool operator==(const InlineBitTuple<N> &lhs,
+                         const InlineBitTuple<N> &rhs);
+
+  typedef std::size_t size_type;
+  typedef util::Word block_type;
+
+  /// default ctor - create an empty tuple
+  InlineBitTuple();
+  /// ctor - create a bit tuple of the specified size. All bits are initialized
+  /// to the specified value
+  explicit InlineBitTuple(size_type newSize, bool defaultVal = false);
+  /// copy ctor
+  InlineBitTuple(const InlineBitTuple &rhs);
+  /// move ctor
+  InlineBitTuple(InlineBitTuple &&rhs);
+
+  /// copy assignment
+  InlineBitTuple &operator=(const InlineBitTuple &rhs);
+  /// move assignment
+  InlineBitTuple &operator=(InlineBitTuple &&rhs);
+
+  /// returns the number of bits
+  size_type size() const { return numBits; }
+  /// returns true iff size() is 0
+  bool empty() const { return numBits == 0; }
+  /// returns true iff the words are held inline
+  bool isInline() const { return !heap; }
+  /// returns the number of words holding the bits
+  size_type num_blocks() const { return (numBits + 63) / 64; }
+  /// the words, lowest bits first
+  const util::Word *data() const { return heap ? heap.get() : inlineWords; }
+
+  /// population count
+  size_type count() const { return util::count(data(), num_blocks()); }
+  /// returns true if any bit is set
+  bool any() const __attribute__((pure));
+  /// returns true if no bit is set
+  bool none() const { return !any(); }
+
+  /// grow or shrink, filling new values as specified
+  void resize(size_type newSize, bool defaultVal = false);
+  /// sets all bits
+  InlineBitTuple &set();
+  /// sets a specific bit
+  InlineBitTuple &set(size_type i) {
+    assert(i < numBits && "Out-of-bounds bit access");
+    words()[i / 64] |= util::Word(1) << (i % 64);
+    return *this;
+  }
+  /// resets all bits
+  InlineBitTuple &reset();
+  /// resets a specific bit
+  InlineBitTuple &reset(size_type i) {
+    assert(i < numBits && "Out-of-bounds bit access");
+    words()[i / 64] &= ~(util::Word(1) << (i % 64));
+    return *this;
+  }
+  /// flips a specific bit
+  InlineBitTuple &flip(size_type i) {
+    assert(i < numBits && "Out-of-bounds bit access");
+    words()[i / 64] ^= util::Word(1) << (i % 64);
+    return *this;
+  }
+
+  /// returns true iff specified bit is true
+  bool test(size_type i) const {
+    assert(i < numBits && "Out-of-bounds bit access");
+    return ((data()[i / 64] >> (i % 64)) & 1) != 0;
+  }
+  /// index
+  bool operator[](size_type i) const { return test(i); }
+
+  /// intersection
+  InlineBitTuple &operator&=(const InlineBitTuple &rhs);
+  /// union
+  InlineBitTuple &operator|=(const InlineBitTuple &rhs);
+  /// symmetric difference
+  InlineBitTuple &operator^=(const InlineBitTuple &rhs);
+  /// difference. Same as *this &= ~rhs
+  InlineBitTuple &operator-=(const InlineBitTuple &rhs);
+
+  /// swap
+  void swap(InlineBitTuple &rhs);
+
+private:
+  util::Word *words() { return heap ? heap.get() : inlineWords; }
+  void clearUnusedBits();
+
+  size_type numBits;
+  // The words once there are more than InlineWords of them, otherwise null
+  std::unique_ptr<util::Word[]> heap;
+  util::Word inlineWords[InlineWords];
+};
+
+/// equality
+template <std::size_t N>
+bool operator==(const InlineBitTuple<N> &lhs,
+                const InlineBitTuple<N> &rhs) __attribute__((pure));
+
+/// inequality
+template <std::size_t N>
+bool operator!=(const InlineBitTuple<N> &lhs, const InlineBitTuple<N> &rhs) {
+  return !(lhs == rhs);
+}
+
+/// intersection
+template <std::size_t N>
+InlineBitTuple<N> operator&(InlineBitTuple<N> lhs,
+                            const InlineBitTuple<N> &rhs) {
+  return lhs &= rhs;
+}
+
+/// union
+template <std::size_t N>
+InlineBitTuple<N> operator|(InlineBitTuple<N> lhs,
+                            const InlineBitTuple<N> &rhs) {
+  return lhs |= rhs;
+}
+
+/// population count of the intersection, without building it
+template <std::size_t N>
+typename InlineBitTuple<N>::size_type
+count_and(const InlineBitTuple<N> &lhs, const InlineBitTuple<N> &rhs) {
+  assert(lhs.size() == rhs.size() &&
+         "Cannot count intersection unless size (universe) is the same");
+  return util::count_and(lhs.data(), rhs.data(), lhs.num_blocks());
+}
+
+/// population count of the union, without building it
+template <std::size_t N>
+typename InlineBitTuple<N>::size_type
+count_or(const InlineBitTuple<N> &lhs, const InlineBitTuple<N> &rhs) {
+  assert(lhs.size() == rhs.size() &&
+         "Cannot count union unless size (universe) is the same");
+  return util::count_or(lhs.data(), rhs.data(), lhs.num_blocks());
+}
+
+/// The words of bits, found by argument dependent lookup alongside
+/// util::blocks for boost::dynamic_bitset
+template <std::size_t N>
+util::BitsetBlocks blocks(const InlineBitTuple<N> &bits) {
+  return util::BitsetBlocks{ bits.data(), bits.num_blocks() };
+}
+} // namespace adt
+
+namespace std {
+template <std::size_t N>
+void swap(adt::InlineBitTuple<N> &lhs, adt::InlineBitTuple<N> &rhs) {
+  lhs.swap(rhs);
+}
+} // namespace std
+
+// Implementation
+//------------------------------------------------------------------------------
+namespace adt {
+template <std::size_t N>
+InlineBitTuple<N>::InlineBitTuple() : numBits(0), heap(), inlineWords() {}
+
+template <std::size_t N>
+InlineBitTuple<N>::InlineBitTuple(size_type newSize, bool defaultVal)
+    : numBits(0), heap(), inlineWords() {
+  resize(newSize, defaultVal);
+}
+
+template <std::size_t N>
+InlineBitTuple<N>::InlineBitTuple(const InlineBitTuple &rhs)
+    : numBits(rhs.numBits), heap(), inlineWords() {
+  if (!rhs.isInline())
+    heap.reset(new util::Word[rhs.num_blocks()]);
+  std::memcpy(words(), rhs.data(), rhs.num_blocks() * sizeof(util::Word));
+}
+
+template <std::size_t N>
+InlineBitTuple<N>::InlineBitTuple(InlineBitTuple &&rhs)
+    : numBits(rhs.numBits), heap(std::move(rhs.heap)), inlineWords() {
+  if (isInline())
+    std::memcpy(inlineWords, rhs.inlineWords, sizeof(inlineWords));
+  rhs.numBits = 0;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator=(const InlineBitTuple &rhs) {
+  if (this == &rhs)
+    return *this;
+
+  // Reuse the heap words when they are exactly the right amount
+  if (rhs.isInline())
+    heap.reset();
+  else if (isInline() || num_blocks() != rhs.num_blocks())
+    heap.reset(new util::Word[rhs.num_blocks()]);
+  numBits = rhs.numBits;
+  std::memcpy(words(), rhs.data(), rhs.num_blocks() * sizeof(util::Word));
+
+  return *this;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator=(InlineBitTuple &&rhs) {
+  if (this == &rhs)
+    return *this;
+
+  numBits = rhs.numBits;
+  heap = std::move(rhs.heap);
+  if (isInline())
+    std::memcpy(inlineWords, rhs.inlineWords, sizeof(inlineWords));
+  rhs.numBits = 0;
+
+  return *this;
+}
+
+template <std::size_t N> bool InlineBitTuple<N>::any() const {
+  // Or everything together rather than branching on each word, so the loop
+  // vectorizes
+  const util::Word *w = data();
+  util::Word bits = 0;
+  for (size_type i = 0, e = num_blocks(); i < e; ++i)
+    bits |= w[i];
+  return bits != 0;
+}
+
+template <std::size_t N>
+void InlineBitTuple<N>::resize(size_type newSize, bool defaultVal) {
+  const size_type oldSize = numBits;
+  const size_type oldWords = num_blocks();
+  const size_type newWords = (newSize + 63) / 64;
+  const util::Word fill = defaultVal ? ~util::Word(0) : util::Word(0);
+
+  // Fill the unused top of the old last word before it is kept
+  if (defaultVal && oldSize % 64 != 0)
+    words()[oldWords - 1] |= ~util::Word(0) << (oldSize % 64);
+
+  if (newWords > N && newWords != oldWords) {
+    // Spill to (or move within) the heap
+    std::unique_ptr<util::Word[]> spilled(new util::Word[newWords]);
+    const size_type kept = std::min(oldWords, newWords);
+    std::memcpy(spilled.get(), data(), kept * sizeof(util::Word));
+    std::fill(spilled.get() + kept, spilled.get() + newWords, fill);
+    heap = std::move(spilled);
+  } else if (newWords <= N && !isInline()) {
+    // Back inline
+    std::memcpy(inlineWords, heap.get(), newWords * sizeof(util::Word));
+    heap.reset();
+  } else if (newWords > oldWords) {
+    std::fill(words() + oldWords, words() + newWords, fill);
+  }
+
+  numBits = newSize;
+  clearUnusedBits();
+}
+
+template <std::size_t N> InlineBitTuple<N> &InlineBitTuple<N>::set() {
+  std::fill(words(), words() + num_blocks(), ~util::Word(0));
+  clearUnusedBits();
+  return *this;
+}
+
+template <std::size_t N> InlineBitTuple<N> &InlineBitTuple<N>::reset() {
+  std::fill(words(), words() + num_blocks(), util::Word(0));
+  return *this;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator&=(const InlineBitTuple &rhs) {
+  assert(
+      size() == rhs.size() &&
+      "Cannot perform intersection (op&=) unless size (universe) is the same");
+  util::Word *lhsWords = words();
+  const util::Word *rhsWords = rhs.data();
+  for (size_type i = 0, e = num_blocks(); i < e; ++i)
+    lhsWords[i] &= rhsWords[i];
+  return *this;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator|=(const InlineBitTuple &rhs) {
+  assert(size() == rhs.size() &&
+         "Cannot perform union (op|=) unless size (universe) is the same");
+  util::Word *lhsWords = words();
+  const util::Word *rhsWords = rhs.data();
+  for (size_type i = 0, e = num_blocks(); i < e; ++i)
+    lhsWords[i] |= rhsWords[i];
+  return *this;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator^=(const InlineBitTuple &rhs) {
+  assert(size() == rhs.size() && "Cannot perform symmetric difference (op^=) "
+                                 "unless size (universe) is the same");
+  util::Word *lhsWords = words();
+  const util::Word *rhsWords = rhs.data();
+  for (size_type i = 0, e = num_blocks(); i < e; ++i)
+    lhsWords[i] ^= rhsWords[i];
+  return *this;
+}
+
+template <std::size_t N>
+InlineBitTuple<N> &InlineBitTuple<N>::operator-=(const InlineBitTuple &rhs) {
+  assert(size() == rhs.size() && "Cannot perform difference (op-=) unless "
+                                 "size (universe) is the same");
+  util::Word *lhsWords = words();
+  const util::Word *rhsWords = rhs.data();
+  for (size_type i = 0, e = num_blocks(); i < e; ++i)
+    lhsWords[i] &= ~rhsWords[i];
+  return *this;
+}
+
+template <std::size_t N> void InlineBitTuple<N>::swap(InlineBitTuple &rhs) {
+  std::swap(numBits, rhs.numBits);
+  std::swap(heap, rhs.heap);
+  std::swap(inlineWords, rhs.inlineWords);
+}
+
+template <std::size_t N> void InlineBitTuple<N>::clearUnusedBits() {
+  const size_type remainder = numBits % 64;
+  if (remainder != 0)
+    words()[num_blocks() - 1] &= (util::Word(1) << remainder) - 1;
+}
+
+// equality
+template <std::size_t N>
+bool operator==(const InlineBitTuple<N> &lhs, const InlineBitTuple<N> &rhs) {
+  return lhs.numBits == rhs.numBits &&
+         std::equal(lhs.data(), lhs.data() + lhs.num_blocks(), rhs.data());
+}
+} // namespace adt
+
+#endif
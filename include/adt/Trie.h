@@ -0,0 +1,367 @@
+//===-- adt/Trie.h - Flat array trie ----------------------------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Trie - a set of strings answering prefix queries, stored as two flat
+/// arrays so it can be written to a file and used again straight from a
+/// mapping of that file
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ADT_TRIE_H_INCLUDED
+#define ADT_TRIE_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace adt {
+/// Trie - a set of strings answering prefix queries
+///
+/// Nodes are numbered breadth first from the root at 0, and the edges leaving
+/// each node are stored together sorted by label. The file format is the
+/// magic "TRI1", then the node count, edge count and word count as uint32,
+/// then the nodes and then the edges exactly as they are held in memory, in
+/// host byte order. A trie can use a mapping of such a file in place through
+/// view rather than copying it with read.
+class Trie {
+public:
+  typedef std::uint32_t Node;
+  /// Returned when there is no such node
+  static const Node npos = static_cast<Node>(-1);
+
+  /// Empty, holding no strings
+  Trie();
+  explicit Trie(const std::vector<std::string> &words);
+
+  Trie(const Trie &other);
+  Trie(Trie &&other);
+  Trie &operator=(const Trie &other);
+  Trie &operator=(Trie &&other);
+
+  Node root() const { return 0; }
+  /// Node reached from n by c, or npos
+  Node child(Node n, char c) const;
+  /// Node reached from the root by prefix, or npos
+  Node find(const std::string &prefix) const;
+  /// Whether some string starts with prefix
+  bool has_prefix(const std::string &prefix) const {
+    return find(prefix) != npos;
+  }
+  /// Whether a string ends at n
+  bool is_word(Node n) const { return nodes[n].terminal != 0; }
+  bool contains(const std::string &word) const {
+    const Node n = find(word);
+    return n != npos && is_word(n);
+  }
+
+  /// Number of strings held
+  std::size_t size() const { return word_count; }
+  std::size_t node_count() const { return num_nodes; }
+
+  void write(std::ostream &out) const;
+  /// Replaces this trie by a copy of one written by write. Returns false,
+  /// leaving this trie empty, if in does not hold one
+  bool read(std::istream &in);
+  /// Replaces this trie by the one written by write at data, used in place.
+  /// data must stay valid and 4 byte aligned for as long as this trie uses it.
+  /// Returns false, leaving this trie empty, if data does not hold a trie
+  bool view(const void *data, std::size_t size);
+
+private:
+  struct NodeRecord {
+    std::uint32_t first_edge;
+    std::uint32_t edge_count;
+    std::uint32_t terminal;
+  };
+  struct EdgeRecord {
+    std::uint32_t label;
+    std::uint32_t target;
+  };
+
+  // Backing storage unless viewing memory owned elsewhere
+  std::vector<NodeRecord> own_nodes;
+  std::vector<EdgeRecord> own_edges;
+
+  const NodeRecord *nodes;
+  const EdgeRecord *edges;
+  std::size_t num_nodes;
+  std::size_t num_edges;
+  std::size_t word_count;
+
+  // Points nodes and edges at the backing storage
+  void adopt();
+  // Copies the header of a file, returning false if it is not one
+  static bool parse_header(const char *header, std::size_t &nodes_,
+                           std::size_t &edges_, std::size_t &words_);
+  // Whether loaded nodes and edges can be searched without leaving them: each
+  // node's edges are within edges and sorted by label, each target is a node,
+  // and words_ nodes are terminal
+  static bool check(const NodeRecord *nodes_, std::size_t num_nodes_,
+                    const EdgeRecord *edges_, std::size_t num_edges_,
+                    std::size_t words_);
+  // Reads count records into records a block at a time, so a header claiming
+  // more than in holds doesn't allocate it all up front
+  template <typename Record>
+  static bool read_records(std::istream &in, std::vector<Record> &records,
+                           std::size_t count);
+  static const std::size_t header_size = 16;
+};
+}
+
+inline adt::Trie::Trie()
+    : own_nodes{ { 0, 0, 0 } }, own_edges(), word_count(0) {
+  adopt();
+}
+
+inline adt::Trie::Trie(const std::vector<std::string> &words) : word_count(0) {
+  // Build with maps first, then lay the nodes out breadth first
+  std::vector<std::map<char, std::size_t> > children(1);
+  std::vector<bool> terminal(1, false);
+  for (const auto &word : words) {
+    std::size_t n = 0;
+    for (const char c : word) {
+      auto found = children[n].find(c);
+      if (found == children[n].end()) {
+        found = children[n].emplace(c, children.size()).first;
+        children.emplace_back();
+        terminal.push_back(false);
+      }
+      n = found->second;
+    }
+    if (!terminal[n])
+      ++word_count;
+    terminal[n] = true;
+  }
+
+  std::vector<std::size_t> order{ 0 };
+  std::vector<Node> renumbered(children.size());
+  renumbered[0] = 0;
+  for (std::size_t i = 0; i < order.size(); ++i)
+    for (const auto &edge : children[order[i]]) {
+      renumbered[edge.second] = static_cast<Node>(order.size());
+      order.push_back(edge.second);
+    }
+
+  own_nodes.reserve(order.size());
+  own_edges.reserve(order.size() - 1);
+  for (const auto old : order) {
+    own_nodes.push_back({ static_cast<std::uint32_t>(own_edges.size()),
+                          static_cast<std::uint32_t>(children[old].size()),
+                          terminal[old] ? 1u : 0u });
+    // std::map keeps the labels sorted
+    for (const auto &edge : children[old])
+      own_edges.push_back(
+          { static_cast<unsigned char>(edge.first), renumbered[edge.second] });
+  }
+  adopt();
+}
+
+inline adt::Trie::Trie(const Trie &other)
+    : own_nodes(other.own_nodes), own_edges(other.own_edges),
+      nodes(other.nodes), edges(other.edges), num_nodes(other.num_nodes),
+      num_edges(other.num_edges), word_count(other.word_count) {
+  if (!own_nodes.empty())
+    adopt();
+}
+
+inline adt::Trie::Trie(Trie &&other)
+    : own_nodes(std::move(other.own_nodes)),
+      own_edges(std::move(other.own_edges)), nodes(other.nodes),
+      edges(other.edges), num_nodes(other.num_nodes),
+      num_edges(other.num_edges), word_count(other.word_count) {
+  if (!own_nodes.empty())
+    adopt();
+  other = Trie();
+}
+
+inline adt::Trie &adt::Trie::operator=(const Trie &other) {
+  if (this != &other)
+    *this = Trie(other);
+  return *this;
+}
+
+inline adt::Trie &adt::Trie::operator=(Trie &&other) {
+  if (this == &other)
+    return *this;
+  own_nodes = std::move(other.own_nodes);
+  own_edges = std::move(other.own_edges);
+  nodes = other.nodes;
+  edges = other.edges;
+  num_nodes = other.num_nodes;
+  num_edges = other.num_edges;
+  word_count = other.word_count;
+  if (!own_nodes.empty())
+    adopt();
+
+  other.own_nodes.assign(1, { 0, 0, 0 });
+  other.own_edges.clear();
+  other.word_count = 0;
+  other.adopt();
+  return *this;
+}
+
+inline void adt::Trie::adopt() {
+  nodes = own_nodes.data();
+  edges = own_edges.data();
+  num_nodes = own_nodes.size();
+  num_edges = own_edges.size();
+}
+
+inline adt::Trie::Node adt::Trie::child(Node n, char c) const {
+  const std::uint32_t label = static_cast<unsigned char>(c);
+  const EdgeRecord *first = edges + nodes[n].first_edge;
+  const EdgeRecord *last = first + nodes[n].edge_count;
+  const EdgeRecord *found = std::lower_bound(
+      first, last, label,
+      [](const EdgeRecord &e, std::uint32_t l) { return e.label < l; });
+  if (found == last || found->label != label)
+    return npos;
+  return found->target;
+}
+
+inline adt::Trie::Node adt::Trie::find(const std::string &prefix) const {
+  Node n = root();
+  for (const char c : prefix) {
+    n = child(n, c);
+    if (n == npos)
+      break;
+  }
+  return n;
+}
+
+inline void adt::Trie::write(std::ostream &out) const {
+  const std::uint32_t counts[3] = { static_cast<std::uint32_t>(num_nodes),
+                                    static_cast<std::uint32_t>(num_edges),
+                                    static_cast<std::uint32_t>(word_count) };
+  out.write("TRI1", 4);
+  out.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+  out.write(reinterpret_cast<const char *>(nodes),
+            static_cast<std::streamsize>(num_nodes * sizeof(NodeRecord)));
+  out.write(reinterpret_cast<const char *>(edges),
+            static_cast<std::streamsize>(num_edges * sizeof(EdgeRecord)));
+}
+
+inline bool adt::Trie::parse_header(const char *header, std::size_t &nodes_,
+                                    std::size_t &edges_,
+                                    std::size_t &words_) {
+  if (std::memcmp(header, "TRI1", 4) != 0)
+    return false;
+  std::uint32_t counts[3];
+  std::memcpy(counts, header + 4, sizeof(counts));
+  nodes_ = counts[0];
+  edges_ = counts[1];
+  words_ = counts[2];
+  // A tree always has its root and one fewer edge than nodes
+  return nodes_ != 0 && edges_ + 1 == nodes_;
+}
+
+inline bool adt::Trie::check(const NodeRecord *nodes_,
+                             std::size_t num_nodes_,
+                             const EdgeRecord *edges_,
+                             std::size_t num_edges_, std::size_t words_) {
+  std::size_t terminals = 0;
+  for (std::size_t n = 0; n < num_nodes_; ++n) {
+    const NodeRecord &node = nodes_[n];
+    if (node.first_edge > num_edges_ ||
+        node.edge_count > num_edges_ - node.first_edge || node.terminal > 1)
+      return false;
+    terminals += node.terminal;
+
+    const EdgeRecord *first = edges_ + node.first_edge;
+    for (const EdgeRecord *e = first; e != first + node.edge_count; ++e) {
+      if (e->label > 255 || e->target >= num_nodes_ ||
+          (e != first && e[-1].label >= e->label))
+        return false;
+    }
+  }
+  return terminals == words_;
+}
+
+template <typename Record>
+bool adt::Trie::read_records(std::istream &in, std::vector<Record> &records,
+                             std::size_t count) {
+  const std::size_t block = 1 << 16;
+  records.clear();
+  while (records.size() < count) {
+    const std::size_t start = records.size();
+    records.resize(start + std::min(block, count - start));
+    if (!in.read(reinterpret_cast<char *>(records.data() + start),
+                 static_cast<std::streamsize>((records.size() - start) *
+                                              sizeof(Record))))
+      return false;
+  }
+  return true;
+}
+
+inline bool adt::Trie::read(std::istream &in) {
+  *this = Trie();
+
+  char header[header_size];
+  std::size_t nodes_, edges_, words_;
+  if (!in.read(header, sizeof(header)) ||
+      !parse_header(header, nodes_, edges_, words_))
+    return false;
+
+  Trie result;
+  if (!read_records(in, result.own_nodes, nodes_) ||
+      !read_records(in, result.own_edges, edges_) ||
+      !check(result.own_nodes.data(), nodes_, result.own_edges.data(), edges_,
+             words_))
+    return false;
+  result.word_count = words_;
+  result.adopt();
+
+  *this = std::move(result);
+  return true;
+}
+
+inline bool adt::Trie::view(const void *data, std::size_t size) {
+  *this = Trie();
+
+  const char *bytes = static_cast<const char *>(data);
+  std::size_t nodes_, edges_, words_;
+  if (size < header_size || !parse_header(bytes, nodes_, edges_, words_) ||
+      size < header_size + nodes_ * sizeof(NodeRecord) +
+                 edges_ * sizeof(EdgeRecord))
+    return false;
+
+  const NodeRecord *nodes_data =
+      reinterpret_cast<const NodeRecord *>(bytes + header_size);
+  const EdgeRecord *edges_data = reinterpret_cast<const EdgeRecord *>(
+      bytes + header_size + nodes_ * sizeof(NodeRecord));
+  if (!check(nodes_data, nodes_, edges_data, edges_, words_))
+    return false;
+
+  own_nodes.clear();
+  nodes = nodes_data;
+  edges = edges_data;
+  num_nodes = nodes_;
+  num_edges = edges_;
+  word_count = words_;
+  return true;
+}
+
+#endif
@@ -24,12 +24,15 @@
 #ifndef BFEATTACKS_ACCUMULATOR_H_INCLUDED
 #define BFEATTACKS_ACCUMULATOR_H_INCLUDED
 
+#include <algorithm>
+#include <map>
 #include <ostream>
 #include <string>
 #include <vector>
 
 #include "bfeattacks/SingleRecord.h"
 #include "concurrent/Accumulator.h"
+#include "graph/Estimate.h"
 #include "graph/Traversals.h"
 
 #include <iostream>
@@ -58,16 +61,50 @@ private:
   concurrent::Accumulator<size_t> graph_vertices_all;
   concurrent::Accumulator<size_t> graph_vertices_real;
   concurrent::Accumulator<size_t> graph_vertices_false;
+  concurrent::Accumulator<size_t> graph_vertices_trimmed;
   concurrent::Accumulator<size_t> graph_edges;
+  // 1 for each record whose graph has no cycles, 0 otherwise
+  concurrent::Accumulator<size_t> graph_acyclic;
+  // Path counts of the acyclic graphs, found without enumerating them
+  concurrent::Accumulator<size_t> graph_dag_paths;
+
+  // Records given to SingleRecord::run_adaptive, by the strategy picked
+  std::map<graph::Strategy, size_t> adaptive_strategy;
+  concurrent::Accumulator<double> adaptive_estimated_nodes;
+  concurrent::Accumulator<size_t> adaptive_actual_nodes;
+  // Actual over estimated nodes, for all but count_only
+  concurrent::Accumulator<double> adaptive_node_ratio;
+  concurrent::Accumulator<double> adaptive_estimated_paths;
+  concurrent::Accumulator<size_t> adaptive_actual_paths;
+  // 1 if the candidates included the inserted word, 0 otherwise
+  concurrent::Accumulator<size_t> adaptive_found;
+  // 1 if the search ran out of budget, 0 otherwise
+  concurrent::Accumulator<size_t> adaptive_truncated;
+
+  // Records given to SingleRecord::run_ranked. Rank of the inserted word among
+  // the candidates, from 1, when it was found
+  concurrent::Accumulator<size_t> ranked_rank;
+  // 1 if the inserted word was among the candidates, 0 otherwise
+  concurrent::Accumulator<size_t> ranked_found;
+  // 1 if the search ran out of budget, 0 otherwise
+  concurrent::Accumulator<size_t> ranked_truncated;
 
   struct traversalStat {
     concurrent::Accumulator<size_t> total_guess_set;
     concurrent::Accumulator<size_t> correct_guess_set;
     concurrent::Accumulator<size_t> incorrect_guess_set;
+    // Records whose traversal ran out of budget, which are in none of the
+    // above
+    concurrent::Accumulator<size_t> truncated_guess_set;
 
     std::vector<std::string> missed;
+    std::vector<std::string> truncated;
   };
   std::vector<traversalStat> traversalStats;
+  // Records given to search_dictionary, as if another traversal
+  traversalStat prunedStat;
+  // Records given to DictionaryEncoding::lookup, as if another traversal
+  traversalStat dictionaryStat;
 
   size_t trials = 0;
 };
@@ -84,32 +121,105 @@ void bfeattacks::Accumulator::add(bfeattacks::SingleRecord<T> &record) {
   graph_vertices_all.add(record.bf.potential_members(record.alphabet).size());
   graph_vertices_real.add(record.bf.true_members().size());
   graph_vertices_false.add(record.bf.false_members().size());
+  graph_vertices_trimmed.add(record.trimmed_vertices);
 
   graph_edges.add(record.edges.size());
+  graph_acyclic.add(record.acyclic ? 1 : 0);
+  if (record.acyclic)
+    graph_dag_paths.add(record.dag_paths);
 
   ++trials;
 
+  if (record.adaptive.ran) {
+    const auto &run = record.adaptive;
+    ++adaptive_strategy[run.plan.strategy];
+    adaptive_estimated_nodes.add(run.plan.estimate.nodes);
+    adaptive_estimated_paths.add(run.plan.estimate.paths);
+    if (run.plan.strategy != graph::Strategy::count_only) {
+      if (!run.reused) {
+        adaptive_actual_nodes.add(run.nodes);
+        adaptive_node_ratio.add(static_cast<double>(run.nodes) /
+                                run.plan.estimate.nodes);
+      }
+      adaptive_actual_paths.add(run.candidates.size());
+    }
+    adaptive_found.add(std::find(run.candidates.begin(), run.candidates.end(),
+                                 record.inserted[0]) != run.candidates.end()
+                           ? 1
+                           : 0);
+    adaptive_truncated.add(run.truncated ? 1 : 0);
+  }
+
+  if (record.ranked.ran) {
+    const auto &run = record.ranked;
+    const auto word = std::find(run.candidates.begin(), run.candidates.end(),
+                                record.inserted[0]);
+    ranked_found.add(word != run.candidates.end() ? 1 : 0);
+    if (word != run.candidates.end())
+      ranked_rank.add(static_cast<size_t>(word - run.candidates.begin()) + 1);
+    ranked_truncated.add(run.truncated ? 1 : 0);
+  }
+
+  if (record.pruned.ran) {
+    const auto &guesses = record.pruned.candidates;
+    if (record.pruned.truncated) {
+      prunedStat.truncated_guess_set.add(guesses.size());
+      prunedStat.truncated.push_back(record.inserted[0]);
+    } else {
+      prunedStat.total_guess_set.add(guesses.size());
+      if (std::find(guesses.begin(), guesses.end(), record.inserted[0]) !=
+          guesses.end()) {
+        prunedStat.correct_guess_set.add(guesses.size());
+      } else {
+        prunedStat.incorrect_guess_set.add(guesses.size());
+        prunedStat.missed.push_back(record.inserted[0]);
+      }
+    }
+  }
+
+  if (record.dictionary.ran) {
+    const auto &guesses = record.dictionary.candidates;
+    dictionaryStat.total_guess_set.add(guesses.size());
+    if (std::find(guesses.begin(), guesses.end(), record.inserted[0]) !=
+        guesses.end()) {
+      dictionaryStat.correct_guess_set.add(guesses.size());
+    } else {
+      dictionaryStat.incorrect_guess_set.add(guesses.size());
+      dictionaryStat.missed.push_back(record.inserted[0]);
+    }
+  }
+
   // Stats per traversal type
   for (std::vector<graph::Traversal>::size_type i = 0, e = traversals.size();
        i < e; ++i) {
-    auto paths = record.get_simplified_paths(traversals[i]);
+    // Candidates collected into a set with collect_candidates are looked up
+    // there, otherwise the simplified paths are scanned
+    const bool collected = record.is_collected(traversals[i]);
+    const auto &candidates = record.get_candidates(traversals[i]);
+    const std::vector<std::string> *paths =
+        collected ? nullptr : &record.get_simplified_paths(traversals[i]);
+    const size_t guesses = collected ? candidates.size() : paths->size();
+
+    if (record.is_truncated(traversals[i])) {
+      traversalStats[i].truncated_guess_set.add(guesses);
+      traversalStats[i].truncated.push_back(record.inserted[0]);
+      continue;
+    }
 
-    traversalStats[i].total_guess_set.add(paths.size());
+    traversalStats[i].total_guess_set.add(guesses);
 
-    if (paths.size() > 10000)
+    if (guesses > 10000)
       std::cout << "Word with > 10,000 " << traversals[i] << " paths: "
-		<< record.inserted[0] << " with " << paths.size() << std::endl;
-
-    bool found = false;
-    for (const auto &p : paths) {
-      if (p == record.inserted[0]) {
-	traversalStats[i].correct_guess_set.add(paths.size());
-	found = true;
-	break;
-      }
-    }
-    if (!found) {
-      traversalStats[i].incorrect_guess_set.add(paths.size());
+		<< record.inserted[0] << " with " << guesses << std::endl;
+
+    const bool found =
+        collected ? candidates.contains(record.inserted[0])
+                  : std::find(paths->begin(), paths->end(),
+                              record.inserted[0]) != paths->end();
+    if (found) {
+      traversalStats[i].correct_guess_set.add(guesses);
+    } else {
+      traversalStats[i].incorrect_guess_set.add(guesses);
       traversalStats[i].missed.push_back(record.inserted[0]);
     }
   }
@@ -0,0 +1,135 @@
+//===-- bfeattacks/DictionaryEncoding.h - Dictionary attack -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains DictionaryEncoding, which encodes a whole
+/// dictionary with a known Bloom filter setup so that target filters can be
+/// looked up by their bits, along with reading and writing filter bits as hex.
+///
+//===----------------------------------------------------------------------===//
+#ifndef BFEATTACKS_DICTIONARYENCODING_H_INCLUDED
+#define BFEATTACKS_DICTIONARYENCODING_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "adt/AdaptiveBitset.h"
+#include "bfeattacks/SingleRecord.h"
+#include "concurrent/ThreadPool.h"
+#include "util/BitsetBlocks.h"
+
+namespace bfeattacks {
+/// 64 bit fingerprint of the bits of a filter. Equal bits give equal
+/// fingerprints, and different bits almost never share one
+std::uint64_t fingerprint(const boost::dynamic_bitset<> &bits);
+/// fingerprint of the m bit filter held in words, which may be padded past
+/// the words needed for m bits
+std::uint64_t fingerprint(const util::BitsetBlocks &words, std::size_t m);
+
+/// Bits in the order printed by BloomFilter, lsb first, four to a hex digit
+/// with the first bit as its msb. Zero padded to a whole digit
+std::string filter_to_hex(const boost::dynamic_bitset<> &bits);
+/// Inverse of filter_to_hex for a filter of m bits. Returns false if hex is
+/// not exactly that many digits of hex
+bool filter_from_hex(const std::string &hex, std::size_t m,
+                     boost::dynamic_bitset<> &bits);
+/// filter_to_hex and filter_from_hex for sparse bits, touching only the bits
+/// set rather than every bit
+std::string filter_to_hex(const adt::AdaptiveBitset &bits);
+bool filter_from_hex(const std::string &hex, std::size_t m,
+                     adt::AdaptiveBitset &bits);
+
+template <typename BloomFilter> class DictionaryEncoding {
+public:
+  /// Inserts each word into its own filter from builder, which must be safe
+  /// to call from several threads, spread over pool in blocks of block_size
+  DictionaryEncoding(const std::vector<std::string> &words,
+                     std::function<BloomFilter(void)> builder,
+                     concurrent::ThreadPoolSimple &pool,
+                     std::size_t block_size = 4096);
+
+  /// Words encoding to exactly bits, in dictionary order. Empty if none
+  const std::vector<std::string> &
+  lookup(const boost::dynamic_bitset<> &bits) const;
+  /// Looks up the filter of record, storing the result in record.dictionary
+  void lookup(SingleRecord<BloomFilter> &record) const;
+
+  /// Number of distinct filters the dictionary encodes to
+  std::size_t size() const { return table.size(); }
+
+private:
+  std::unordered_map<std::uint64_t, std::vector<std::string> > table;
+  const std::vector<std::string> none;
+};
+}
+
+template <typename BloomFilter>
+bfeattacks::DictionaryEncoding<BloomFilter>::DictionaryEncoding(
+    const std::vector<std::string> &words,
+    std::function<BloomFilter(void)> builder,
+    concurrent::ThreadPoolSimple &pool, std::size_t block_size) {
+  // Fingerprints are found in parallel, then added in order so each list of
+  // words keeps dictionary order
+  std::vector<std::future<std::vector<std::uint64_t> > > blocks;
+  for (std::size_t start = 0; start < words.size(); start += block_size) {
+    const std::size_t end = std::min(start + block_size, words.size());
+    blocks.push_back(pool.submit([&words, &builder, start, end]() {
+      std::vector<std::uint64_t> prints;
+      prints.reserve(end - start);
+      for (std::size_t i = start; i < end; ++i) {
+        BloomFilter bf = builder();
+        bf.insert(words[i]);
+        prints.push_back(fingerprint(bf.words(), bf.length()));
+      }
+      return prints;
+    }));
+  }
+
+  table.reserve(words.size());
+  std::size_t i = 0;
+  for (auto &block : blocks)
+    for (const auto print : block.get())
+      table[print].push_back(words[i++]);
+}
+
+template <typename BloomFilter>
+const std::vector<std::string> &
+bfeattacks::DictionaryEncoding<BloomFilter>::lookup(
+    const boost::dynamic_bitset<> &bits) const {
+  const auto found = table.find(fingerprint(bits));
+  return found == table.end() ? none : found->second;
+}
+
+template <typename BloomFilter>
+void bfeattacks::DictionaryEncoding<BloomFilter>::lookup(
+    SingleRecord<BloomFilter> &record) const {
+  record.dictionary.ran = true;
+  const auto found =
+      table.find(fingerprint(record.bf.words(), record.bf.length()));
+  record.dictionary.candidates = found == table.end() ? none : found->second;
+}
+
+#endif
@@ -26,26 +26,88 @@
 #define BFEATTACKS_FILTERDICTIONARY_H_INCLUDED
 
 #include <algorithm>
+#include <string>
 
+#include "adt/Trie.h"
 #include "bfeattacks/SingleRecord.h"
+#include "bfeattacks/Streaming.h"
+#include "graph/Traversals.h"
 
 namespace bfeattacks {
 template <typename T>
-void filter_dictionary(bfeattacks::SingleRecord<T> &record);
+void filter_dictionary(bfeattacks::SingleRecord<T> &record,
+                       const adt::Trie &dictionary);
+
+/// Streaming version of filter_dictionary passing candidates on to next.
+/// Branches whose candidate so far starts no word of dictionary are skipped,
+/// so the search only goes as far as dictionary allows. dictionary must
+/// outlive the traversal. Unlike
+/// filter_dictionary, this prunes even when only one candidate would be found.
+/// Use it through SingleRecord::stream_traversal or search_dictionary
+CandidateVisitor filter_dictionary_stage(const adt::Trie &dictionary,
+                                         CandidateVisitor next);
+
+/// Runs all_simple_paths through filter_dictionary_stage, keeping the words
+/// of dictionary it finds in record.pruned. The search stops early if budget
+/// runs out
+template <typename T>
+void search_dictionary(bfeattacks::SingleRecord<T> &record,
+                       const adt::Trie &dictionary,
+                       const graph::Budget &budget = graph::Budget());
 }
 
 template <typename T>
-void bfeattacks::filter_dictionary(bfeattacks::SingleRecord<T> &record) {
+void bfeattacks::filter_dictionary(bfeattacks::SingleRecord<T> &record,
+                                   const adt::Trie &dictionary) {
   for (auto &i : record.simplified_paths) {
     // Only apply if more than one path
     if (i.size() <= 1)
       continue;
 
-    // i.erase(std::remove_if(i.begin(), i.end(), [&record](std::string s) {
-    //   return !record.bf.contains_exactly(s);
-    // }),
-    //         i.end());
+    i.erase(std::remove_if(i.begin(), i.end(),
+                           [&dictionary](const std::string &s) {
+                             return !dictionary.contains(s);
+                           }),
+            i.end());
+  }
+  for (auto &i : record.candidate_sets) {
+    if (i.size() <= 1)
+      continue;
+
+    i.retain([&dictionary](const std::string &s) {
+      return dictionary.contains(s);
+    });
   }
 }
 
+template <typename T>
+void bfeattacks::search_dictionary(bfeattacks::SingleRecord<T> &record,
+                                   const adt::Trie &dictionary,
+                                   const graph::Budget &budget) {
+  record.pruned = PrunedRun();
+  record.pruned.ran = true;
+  record.pruned.truncated = record.stream_traversal(
+      graph::Traversal::all_simple_paths,
+      filter_dictionary_stage(dictionary,
+                              collect_stage(record.pruned.candidates)),
+      budget);
+}
+
+inline bfeattacks::CandidateVisitor
+bfeattacks::filter_dictionary_stage(const adt::Trie &dictionary,
+                                    CandidateVisitor next) {
+  CandidateVisitor stage;
+  stage.extend = [&dictionary, next](const std::string &prefix) {
+    if (!dictionary.has_prefix(prefix))
+      return graph::Visit::skip;
+    return pass_extend(next, prefix);
+  };
+  stage.found = [&dictionary, next](const std::string &candidate) {
+    if (!dictionary.contains(candidate))
+      return graph::Visit::proceed;
+    return pass_found(next, candidate);
+  };
+  return stage;
+}
+
 #endif
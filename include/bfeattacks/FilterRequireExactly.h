@@ -28,23 +28,50 @@
 #ifndef BFEATTACKS_FILTERREQUIREEXACTLY_H_INCLUDED
 #define BFEATTACKS_FILTERREQUIREEXACTLY_H_INCLUDED
 
-#include <algorithm>
+#include <memory>
 
 #include "bfeattacks/SingleRecord.h"
+#include "bfeattacks/Streaming.h"
+#include "bloomfilter/ExactMatcher.h"
 
 namespace bfeattacks {
 template <typename T>
 void filter_require_exactly(bfeattacks::SingleRecord<T> &record);
+
+/// Streaming version of filter_require_exactly passing candidates on to next.
+/// record must outlive the stage
+template <typename T>
+CandidateVisitor
+filter_require_exactly_stage(const bfeattacks::SingleRecord<T> &record,
+                             CandidateVisitor next);
 }
 
 template <typename T>
 void bfeattacks::filter_require_exactly(bfeattacks::SingleRecord<T> &record) {
-  for (auto &i : record.simplified_paths) {
-    i.erase(std::remove_if(i.begin(), i.end(), [&record](std::string s) {
-              return !record.bf.contains_exactly(s);
-            }),
-            i.end());
-  }
+  bloomfilter::ExactMatcher<T> matcher(record.bf);
+
+  for (auto &i : record.simplified_paths)
+    matcher.retain_matches(i);
+  for (auto &i : record.candidate_sets)
+    i.retain([&matcher](const std::string &candidate) {
+      return matcher.matches(candidate);
+    });
+}
+
+template <typename T>
+bfeattacks::CandidateVisitor bfeattacks::filter_require_exactly_stage(
+    const bfeattacks::SingleRecord<T> &record, CandidateVisitor next) {
+  // The stage is copied around as a std::function, so the matcher is shared
+  auto matcher = std::make_shared<bloomfilter::ExactMatcher<T> >(record.bf);
+
+  CandidateVisitor stage;
+  stage.extend = next.extend;
+  stage.found = [matcher, next](const std::string &candidate) {
+    if (!matcher->matches(candidate))
+      return graph::Visit::proceed;
+    return pass_found(next, candidate);
+  };
+  return stage;
 }
 
 #endif
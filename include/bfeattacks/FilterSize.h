@@ -27,12 +27,20 @@
 #include <algorithm>
 
 #include "bfeattacks/SingleRecord.h"
+#include "bfeattacks/Streaming.h"
 
 namespace bfeattacks {
 template <typename T>
 void filter_size(bfeattacks::SingleRecord<T> &record,
                  const std::string::size_type min,
                  const std::string::size_type max);
+
+/// Streaming version of filter_size passing candidates on to next. Since
+/// candidates only grow as the search goes deeper, branches already longer
+/// than max are skipped
+CandidateVisitor filter_size_stage(const std::string::size_type min,
+                                   const std::string::size_type max,
+                                   CandidateVisitor next);
 }
 
 template <typename T>
@@ -46,6 +54,28 @@ void bfeattacks::filter_size(bfeattacks::SingleRecord<T> &record,
         }),
         i.end());
   }
+  for (auto &i : record.candidate_sets)
+    i.retain([min, max](const std::string &s) {
+      return min <= s.size() && s.size() <= max;
+    });
+}
+
+inline bfeattacks::CandidateVisitor
+bfeattacks::filter_size_stage(const std::string::size_type min,
+                              const std::string::size_type max,
+                              CandidateVisitor next) {
+  CandidateVisitor stage;
+  stage.extend = [max, next](const std::string &prefix) {
+    if (prefix.size() > max)
+      return graph::Visit::skip;
+    return pass_extend(next, prefix);
+  };
+  stage.found = [min, max, next](const std::string &candidate) {
+    if (!(min <= candidate.size() && candidate.size() <= max))
+      return graph::Visit::proceed;
+    return pass_found(next, candidate);
+  };
+  return stage;
 }
 
 #endif
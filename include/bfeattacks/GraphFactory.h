@@ -35,11 +35,12 @@
 #include "bloomfilter/BloomFilter.h"
 #include "bloomfilter/InsertionPolicy.h"
 #include "graph/Graph.h"
+#include "util/BitsetBlocks.h"
 
 namespace bfeattacks {
 template <typename Hashes, unsigned int N, bool UseStartSentinel,
           char StartSentinel, bool UseStopSentinel, char StopSentinel,
-          bool TrackEntries>
+          bool TrackEntries, typename Storage>
 graph::Graph_t constructGraph(
     const bloomfilter::BloomFilter<
         Hashes,
@@ -47,7 +48,7 @@ graph::Graph_t constructGraph(
             bloomfilter::InsertionPolicyIteratorNGram<
                 N, UseStartSentinel, StartSentinel, UseStopSentinel,
                 StopSentinel> > >,
-        TrackEntries> &bf,
+        TrackEntries, Storage> &bf,
     const std::string &alphabet);
 
 // vertices is not const since it will be sorted
@@ -67,7 +68,7 @@ std::string simplify_path(const std::vector<std::string> &path,
 
 template <typename Hashes, unsigned int N, bool UseStartSentinel,
           char StartSentinel, bool UseStopSentinel, char StopSentinel,
-          bool TrackEntries>
+          bool TrackEntries, typename Storage>
 graph::Graph_t bfeattacks::constructGraph(
     const bloomfilter::BloomFilter<
         Hashes,
@@ -75,13 +76,24 @@ graph::Graph_t bfeattacks::constructGraph(
             bloomfilter::InsertionPolicyIteratorNGram<
                 N, UseStartSentinel, StartSentinel, UseStopSentinel,
                 StopSentinel> > >,
-        TrackEntries> &bf,
+        TrackEntries, Storage> &bf,
     const std::string &alphabet) {
   auto vertices = bf.potential_members(alphabet);
   auto edges = calculateEdges<N, UseStartSentinel, StartSentinel,
                               UseStopSentinel, StopSentinel>(vertices);
 
-  return constructGraph(vertices, edges);
+  graph::Graph_t g = constructGraph(vertices, edges);
+
+  // Record the bits each vertex accounts for so covering traversals can prune.
+  // constructGraph sorted vertices, so vertices[i] is vertex i + 2 in g.
+  // Storage without words overloads as_dynamic_bitset in its own namespace
+  using util::as_dynamic_bitset;
+  g[boost::graph_bundle].covers = as_dynamic_bitset(bf.raw());
+  for (std::vector<std::string>::size_type i = 0, e = vertices.size(); i != e;
+       ++i)
+    g[i + 2].covers = as_dynamic_bitset(bf.member_bits(vertices[i]));
+
+  return g;
 }
 
 template <int N, bool UseStartSentinel, char StartSentinel,
@@ -23,21 +23,36 @@
 #ifndef BFEATTACKS_PARALLELACCUMULATOR_H_INCLUDED
 #define BFEATTACKS_PARALLELACCUMULATOR_H_INCLUDED
 
+#include <algorithm>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <future>
+#include <iostream>
 #include <iterator>
 #include <ostream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "bfeattacks/Accumulator.h"
 #include "bfeattacks/SingleRecord.h"
+#include "bloomfilter/BitSlicedBlock.h"
 #include "bloomfilter/BloomFilter.h"
 #include "bloomfilter/HashSet.h"
 #include "concurrent/ThreadPool.h"
+#include "graph/Estimate.h"
+#include "graph/Traversals.h"
 
 namespace bfeattacks {
+/// Runs traversals over the filters of input in blocks of blockSize spread
+/// across numThreads. Every record BFBuilder returns must have the same
+/// length and hashes, keys included: each thread finds the potential members
+/// of a batch of records at once by hashing with the first record's filter,
+/// and asserts that the others match it. The traversals in collected stream
+/// their candidates into prefix sharing sets instead of storing their paths,
+/// and are not split across the pool.
 template <typename BFType, typename Container>
 bfeattacks::Accumulator ParallelAccumulate(
     const Container input,
@@ -47,7 +62,12 @@ bfeattacks::Accumulator ParallelAccumulate(
     const typename Container::size_type blockSize,
     const unsigned numThreads = std::thread::hardware_concurrency(),
     std::ostream &out = std::cout,
-    const typename Container::size_type reportMask = 0xFF);
+    const typename Container::size_type reportMask = 0xFF,
+    const std::size_t splitDepth = 0,
+    const graph::Budget budget = graph::Budget(), const bool adaptive = false,
+    const graph::Policy policy = graph::Policy(),
+    const std::vector<graph::Traversal> collected =
+        std::vector<graph::Traversal>());
 
 template <typename BFType, typename Container>
 bfeattacks::Accumulator
@@ -56,7 +76,14 @@ ThreadWorker(typename Container::const_iterator start,
              const std::vector<graph::Traversal> traversals,
              const std::string alphabet,
              std::function<bfeattacks::SingleRecord<BFType>(void)> BFBuilder,
-	     std::function<void(bfeattacks::SingleRecord<BFType>&)> BFFilter);
+	     std::function<void(bfeattacks::SingleRecord<BFType>&)> BFFilter,
+             concurrent::ThreadPoolSimple *pool = nullptr,
+             const std::size_t splitDepth = 0,
+             const graph::Budget budget = graph::Budget(),
+             const bool adaptive = false,
+             const graph::Policy policy = graph::Policy(),
+             const std::vector<graph::Traversal> collected =
+                 std::vector<graph::Traversal>());
 }
 
 namespace bfeattacks {
@@ -67,13 +94,18 @@ bfeattacks::Accumulator ParallelAccumulate(
     std::function<void(bfeattacks::SingleRecord<BFType>&)> BFFilter,
     const std::vector<graph::Traversal> traversals, const std::string alphabet,
     const typename Container::size_type blockSize, const unsigned numThreads,
-    std::ostream &out, const typename Container::size_type reportMask) {
+    std::ostream &out, const typename Container::size_type reportMask,
+    const std::size_t splitDepth, const graph::Budget budget,
+    const bool adaptive, const graph::Policy policy,
+    const std::vector<graph::Traversal> collected) {
   // ceiling of input.size() / blockSize
   const typename Container::size_type numBlocks =
       (input.size() + blockSize - 1) / blockSize;
 
   std::vector<std::future<bfeattacks::Accumulator> > futures(numBlocks);
   concurrent::ThreadPoolSimple pool(numThreads);
+  // Large records split their traversals into tasks in this same pool
+  concurrent::ThreadPoolSimple *splitPool = splitDepth > 0 ? &pool : nullptr;
 
   // Submit everything
   auto blockStart = input.begin();
@@ -81,27 +113,32 @@ bfeattacks::Accumulator ParallelAccumulate(
     auto blockEnd = blockStart;
     std::advance(blockEnd, blockSize);
     futures[i] = pool.submit([blockStart, blockEnd, traversals, alphabet,
-                              BFBuilder, BFFilter]() {
-      return ThreadWorker<BFType, Container>(blockStart, blockEnd, traversals,
-                                             alphabet, BFBuilder, BFFilter);
+                              BFBuilder, BFFilter, splitPool, splitDepth,
+                              budget, adaptive, policy, collected]() {
+      return ThreadWorker<BFType, Container>(
+          blockStart, blockEnd, traversals, alphabet, BFBuilder, BFFilter,
+          splitPool, splitDepth, budget, adaptive, policy, collected);
     });
     blockStart = blockEnd;
   }
   // Last block submitted separately to avoid undefined behavior triggered by
   // considering an iterator advanced past the end of the container
   futures[numBlocks - 1] =
-    pool.submit([blockStart, &input, traversals, alphabet, BFBuilder, BFFilter]() {
+    pool.submit([blockStart, &input, traversals, alphabet, BFBuilder, BFFilter,
+                 splitPool, splitDepth, budget, adaptive, policy,
+                 collected]() {
         return ThreadWorker<BFType, Container>(
-            blockStart, input.end(), traversals, alphabet, BFBuilder, BFFilter);
+            blockStart, input.end(), traversals, alphabet, BFBuilder, BFFilter,
+            splitPool, splitDepth, budget, adaptive, policy, collected);
       });
-  out << "Tasks all in queue" << endl;
+  out << "Tasks all in queue" << std::endl;
 
   // Collect results
   bfeattacks::Accumulator stats(traversals);
   for (typename Container::size_type i = 0; i < numBlocks; ++i) {
     stats += futures[i].get();
     if ((i & reportMask) == 0)
-      out << "Completed tasks: " << i + 1 << "/" << numBlocks << endl;
+      out << "Completed tasks: " << i + 1 << "/" << numBlocks << std::endl;
   }
 
   return stats;
@@ -114,30 +151,64 @@ ThreadWorker(typename Container::const_iterator start,
              const std::vector<graph::Traversal> traversals,
              const std::string alphabet,
              std::function<bfeattacks::SingleRecord<BFType>(void)> BFBuilder,
-	     std::function<void(bfeattacks::SingleRecord<BFType>&)> BFFilter) {
+	     std::function<void(bfeattacks::SingleRecord<BFType>&)> BFFilter,
+             concurrent::ThreadPoolSimple *pool, const std::size_t splitDepth,
+             const graph::Budget budget, const bool adaptive,
+             const graph::Policy policy,
+             const std::vector<graph::Traversal> collected) {
   bfeattacks::Accumulator stats(traversals);
 
-  for (typename Container::const_iterator word = start; word != end; ++word) {
-    // Construct the record
-    auto rec = BFBuilder();
-
-    // Populate the bloom filter
-    rec.insert(*word);
-
-    // Construct the graph
-    rec.construct_graph(alphabet);
-
-    // Run the traversals
-    rec.setup_traversals(traversals);
-    for (const auto i : traversals)
-      rec.run_traversal(i);
-    rec.simplify_paths();
-
-    // Apply filters
-    BFFilter(rec);
-
-    // Collect stats
-    stats.add(rec);
+  // Records are built a batch at a time, so the potential members of all
+  // their filters are found at once, bit sliced
+  const std::size_t batchSize = 256;
+  // A deque, as records can only be moved and never need relocating
+  std::deque<bfeattacks::SingleRecord<BFType> > batch;
+  std::vector<const BFType *> filters;
+  filters.reserve(batchSize);
+
+  for (typename Container::const_iterator word = start; word != end;) {
+    // Construct the records and populate their bloom filters
+    batch.clear();
+    for (; word != end && batch.size() < batchSize; ++word) {
+      batch.push_back(BFBuilder());
+      batch.back().insert(*word);
+    }
+
+    // Relies on BFBuilder giving every record the same m and hashes, which
+    // potential_members_batch asserts
+    filters.clear();
+    for (const auto &rec : batch)
+      filters.push_back(&rec.bf);
+    bloomfilter::potential_members_batch(filters, alphabet);
+
+    for (auto &batched : batch) {
+      // Taken out of the batch so its graph and paths go once it is counted
+      auto rec = std::move(batched);
+
+      // Construct the graph
+      rec.construct_graph(alphabet);
+
+      // Run the traversals
+      rec.setup_traversals(traversals);
+      for (const auto i : traversals) {
+        if (std::find(collected.begin(), collected.end(), i) !=
+            collected.end())
+          rec.collect_candidates(i, budget);
+        else if (pool)
+          rec.run_traversal(i, *pool, splitDepth, budget);
+        else
+          rec.run_traversal(i, budget);
+      }
+      rec.simplify_paths();
+      if (adaptive)
+        rec.run_adaptive(policy, budget);
+
+      // Apply filters
+      BFFilter(rec);
+
+      // Collect stats
+      stats.add(rec);
+    }
   }
 
   return stats;
@@ -24,29 +24,113 @@
 #ifndef BFEATTACKS_SINGLERECORD_H_INCLUDED
 #define BFEATTACKS_SINGLERECORD_H_INCLUDED
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <map>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include "adt/CandidateSet.h"
 #include "bfeattacks/GraphFactory.h"
+#include "bfeattacks/Streaming.h"
 #include "bloomfilter/BloomFilter.h"
+#include "concurrent/ThreadPool.h"
+#include "graph/Dag.h"
+#include "graph/Estimate.h"
 #include "graph/Graph.h"
 #include "graph/Traversals.h"
+#include "graph/Trim.h"
+#include "stats/NGramModel.h"
 
 #include <boost/graph/graphml.hpp>
 
 namespace bfeattacks {
+/// What SingleRecord::run_adaptive did
+struct AdaptiveRun {
+  bool ran = false;
+  graph::Plan plan;
+  /// Vertices discovered other than the sink, to compare with
+  /// plan.estimate.nodes
+  std::size_t nodes = 0;
+  /// Whether a full search took the candidates of the fixed all_simple_paths
+  /// traversal rather than enumerating them again, so counted no nodes
+  bool reused = false;
+  /// Whether the search ran out of budget, leaving candidates incomplete
+  bool truncated = false;
+  /// Empty for count_only
+  std::vector<std::string> candidates;
+};
+
+/// What SingleRecord::run_ranked found
+struct RankedRun {
+  bool ran = false;
+  bool truncated = false;
+  /// Most plausible first, without repeats
+  std::vector<std::string> candidates;
+  /// Log probability of each candidate
+  std::vector<double> scores;
+};
+
+/// What search_dictionary found
+struct PrunedRun {
+  bool ran = false;
+  bool truncated = false;
+  /// Candidates that are words of the dictionary, as all_simple_paths finds
+  /// them
+  std::vector<std::string> candidates;
+};
+
+/// What DictionaryEncoding::lookup found
+struct DictionaryRun {
+  bool ran = false;
+  /// Dictionary words whose filter has exactly the bits of this one
+  std::vector<std::string> candidates;
+};
+
 template <typename BloomFilter> class SingleRecord {
 public:
   template <typename A>
   friend std::ostream &operator<<(std::ostream &out, const SingleRecord<A> &r);
 
-  SingleRecord(BloomFilter bf_) : bf(bf_), source(0), sink(1) {}
+  SingleRecord(BloomFilter bf_)
+      : bf(bf_), source(0), sink(1), trimmed_vertices(0), acyclic(false),
+        dag_paths(0) {}
 
   void setup_traversals(const std::vector<graph::Traversal> &t);
   void run_traversal(const graph::Traversal t);
+  void run_traversal(const graph::Traversal t, const graph::Budget &budget);
+  void run_traversal(const graph::Traversal t,
+                     concurrent::ThreadPoolSimple &pool,
+                     std::size_t split_depth,
+                     const graph::Budget &budget = graph::Budget());
+  // Whether traversal t ran out of budget before finishing
+  bool is_truncated(const graph::Traversal t);
+  // Passes the simplified candidates of traversal t to visitor as they are
+  // found, without storing them. Returns true if stopped early
+  bool stream_traversal(const graph::Traversal t,
+                        const CandidateVisitor &visitor,
+                        const graph::Budget &budget = graph::Budget());
+  // Estimates the cost of all_simple_paths and finds candidates by whichever
+  // strategy policy picks from it. When policy.max_length is zero, the length
+  // bound comes from the number of n-grams bf is estimated to hold. The search
+  // stops early if budget runs out. A full search reuses all_simple_paths if
+  // it already ran and its paths were simplified
+  void run_adaptive(const graph::Policy &policy = graph::Policy(),
+                    const graph::Budget &budget = graph::Budget());
+  // Finds the k most plausible candidates under model, best first, or all of
+  // them if k is zero. Paths simplifying to the same candidate count once
+  void run_ranked(const stats::NGramModel &model, std::size_t k,
+                  const graph::Budget &budget = graph::Budget());
+  // Streams traversal t straight into a prefix sharing set of its distinct
+  // candidates, without storing its paths. Returns true if stopped early
+  bool collect_candidates(const graph::Traversal t,
+                          const graph::Budget &budget = graph::Budget());
+  // Whether traversal t was run by collect_candidates, so its candidates are
+  // in get_candidates rather than get_simplified_paths
+  bool is_collected(const graph::Traversal t);
+  const adt::CandidateSet &get_candidates(const graph::Traversal t);
   void simplify_paths();
   const std::vector<std::string> &
   get_simplified_paths(const graph::Traversal t);
@@ -62,8 +146,21 @@ public:
   std::string alphabet;
   std::vector<std::string> inserted;
   std::vector<std::string> edges;
+  // Vertices dropped from g by graph::trim since they are on no path
+  std::size_t trimmed_vertices;
+  // Whether g has no cycles, and if so its number of source to sink paths,
+  // which is how many all_simple_paths finds
+  bool acyclic;
+  std::size_t dag_paths;
   std::vector<std::vector<std::vector<std::string> > > paths;
   std::vector<std::vector<std::string> > simplified_paths;
+  std::vector<bool> truncated;
+  std::vector<bool> collected;
+  std::vector<adt::CandidateSet> candidate_sets;
+  AdaptiveRun adaptive;
+  RankedRun ranked;
+  PrunedRun pruned;
+  DictionaryRun dictionary;
   std::map<graph::Traversal, unsigned> traversals;
 };
 
@@ -86,6 +183,11 @@ void bfeattacks::SingleRecord<T>::setup_traversals(
     traversals[i] = count++;
 
   paths.resize(traversals.size());
+  simplified_paths.clear();
+  truncated.assign(traversals.size(), false);
+  collected.assign(traversals.size(), false);
+  candidate_sets.clear();
+  candidate_sets.resize(traversals.size());
 }
 
 template <typename T>
@@ -95,6 +197,182 @@ void bfeattacks::SingleRecord<T>::run_traversal(const graph::Traversal t) {
   graph::run_traversal(g, source, sink, paths[index], t);
 }
 
+template <typename T>
+void bfeattacks::SingleRecord<T>::run_traversal(const graph::Traversal t,
+                                                const graph::Budget &budget) {
+  unsigned index = traversals[t];
+
+  truncated[index] =
+      graph::run_traversal(g, source, sink, paths[index], t, budget);
+}
+
+template <typename T>
+void bfeattacks::SingleRecord<T>::run_traversal(
+    const graph::Traversal t, concurrent::ThreadPoolSimple &pool,
+    std::size_t split_depth, const graph::Budget &budget) {
+  unsigned index = traversals[t];
+
+  truncated[index] = graph::run_traversal(g, source, sink, paths[index], t,
+                                          pool, split_depth, budget);
+}
+
+template <typename T>
+bool bfeattacks::SingleRecord<T>::is_truncated(const graph::Traversal t) {
+  return truncated[traversals[t]];
+}
+
+template <typename T>
+bool bfeattacks::SingleRecord<T>::stream_traversal(
+    const graph::Traversal t, const CandidateVisitor &visitor,
+    const graph::Budget &budget) {
+  std::vector<std::string> names;
+  auto simplify = [this, &names](const std::vector<graph::Vertex_t> &path) {
+    names.clear();
+    for (const auto v : path)
+      names.push_back(g[v].name);
+    return simplify_path(names, true, '^');
+  };
+
+  graph::PathVisitor streamer;
+  if (visitor.extend)
+    streamer.extend = [&visitor, &simplify](
+        const std::vector<graph::Vertex_t> &branch) {
+      return visitor.extend(simplify(branch));
+    };
+  if (visitor.found)
+    streamer.found = [&visitor, &simplify](
+        const std::vector<graph::Vertex_t> &path) {
+      return visitor.found(simplify(path));
+    };
+
+  return graph::run_traversal(g, source, sink, streamer, t, budget);
+}
+
+template <typename T>
+bool bfeattacks::SingleRecord<T>::collect_candidates(
+    const graph::Traversal t, const graph::Budget &budget) {
+  unsigned index = traversals[t];
+
+  candidate_sets[index].clear();
+  collected[index] = true;
+  truncated[index] =
+      stream_traversal(t, collect_set_stage(candidate_sets[index]), budget);
+  return truncated[index];
+}
+
+template <typename T>
+bool bfeattacks::SingleRecord<T>::is_collected(const graph::Traversal t) {
+  return collected[traversals[t]];
+}
+
+template <typename T>
+const adt::CandidateSet &
+bfeattacks::SingleRecord<T>::get_candidates(const graph::Traversal t) {
+  return candidate_sets[traversals[t]];
+}
+
+template <typename T>
+void bfeattacks::SingleRecord<T>::run_adaptive(const graph::Policy &policy,
+                                               const graph::Budget &budget) {
+  graph::Policy bounded = policy;
+  // A path is Source, the n-grams of a word, then Sink, so has one more edge
+  // than there are n-grams. Allow a couple more for error in the estimate
+  if (bounded.max_length == 0)
+    bounded.max_length =
+        static_cast<std::size_t>(std::ceil(estimate_elements())) + 3;
+
+  adaptive = AdaptiveRun();
+  adaptive.ran = true;
+  adaptive.plan = graph::plan_traversal(g, source, sink, bounded);
+  if (adaptive.plan.strategy == graph::Strategy::count_only)
+    return;
+
+  if (adaptive.plan.strategy == graph::Strategy::full) {
+    const auto fixed = traversals.find(graph::Traversal::all_simple_paths);
+    if (fixed != traversals.end() && fixed->second < simplified_paths.size()) {
+      adaptive.reused = true;
+      adaptive.candidates = simplified_paths[fixed->second];
+      adaptive.truncated = truncated[fixed->second];
+      return;
+    }
+  }
+
+  const graph::Traversal t =
+      adaptive.plan.strategy == graph::Strategy::covering
+          ? graph::Traversal::all_covering_paths
+          : graph::Traversal::all_simple_paths;
+  const std::size_t max_length =
+      adaptive.plan.strategy == graph::Strategy::length_bounded
+          ? bounded.max_length
+          : 0;
+
+  std::vector<std::string> names;
+  graph::PathVisitor visitor;
+  visitor.extend = [this, max_length](
+      const std::vector<graph::Vertex_t> &branch) {
+    ++adaptive.nodes;
+    if (max_length != 0 && branch.size() > max_length)
+      return graph::Visit::skip;
+    return graph::Visit::proceed;
+  };
+  visitor.found = [this, &names](const std::vector<graph::Vertex_t> &path) {
+    names.clear();
+    for (const auto v : path)
+      names.push_back(g[v].name);
+    adaptive.candidates.push_back(simplify_path(names, true, '^'));
+    return graph::Visit::proceed;
+  };
+
+  adaptive.truncated =
+      graph::run_traversal(g, source, sink, visitor, t, budget);
+}
+
+template <typename T>
+void bfeattacks::SingleRecord<T>::run_ranked(const stats::NGramModel &model,
+                                             std::size_t k,
+                                             const graph::Budget &budget) {
+  // The characters of a branch are those simplify_path would give it
+  std::string history;
+  auto score = [this, &model, &history](
+      const std::vector<graph::Vertex_t> &branch, graph::Vertex_t next) {
+    history.clear();
+    for (const auto v : branch)
+      if (v != source && v != sink && g[v].name[0] != '^')
+        history += g[v].name[0];
+
+    if (next == sink)
+      return model.log_probability_end(history);
+    if (g[next].name[0] == '^')
+      return 0.0;
+    return model.log_probability(history, g[next].name[0]);
+  };
+
+  ranked = RankedRun();
+  ranked.ran = true;
+
+  std::vector<std::string> names;
+  auto keep = [this, k, &names](const std::vector<graph::Vertex_t> &path,
+                                double path_score) {
+    names.clear();
+    for (const auto v : path)
+      names.push_back(g[v].name);
+    std::string candidate = simplify_path(names, true, '^');
+    if (std::find(ranked.candidates.begin(), ranked.candidates.end(),
+                  candidate) != ranked.candidates.end())
+      return graph::Visit::proceed;
+
+    ranked.candidates.push_back(std::move(candidate));
+    ranked.scores.push_back(path_score);
+    return ranked.candidates.size() == k ? graph::Visit::stop
+                                         : graph::Visit::proceed;
+  };
+
+  // Reaching k candidates isn't stopping early
+  ranked.truncated =
+      graph::best_first_paths(g, source, sink, score, keep, budget) &&
+      ranked.candidates.size() != k;
+}
+
 template <typename T>
 const std::vector<std::string> &
 bfeattacks::SingleRecord<T>::get_simplified_paths(const graph::Traversal t) {
@@ -118,6 +396,11 @@ bfeattacks::SingleRecord<T>::construct_graph(const std::string &alphabet_) {
   alphabet = alphabet_;
   edges = bf.potential_members(alphabet);
   g = bfeattacks::constructGraph(bf, alphabet);
+  trimmed_vertices = graph::trim(g, source, sink);
+
+  std::vector<graph::Vertex_t> order;
+  acyclic = graph::topological_order(g, order);
+  dag_paths = acyclic ? graph::count_paths_to(g, order, sink)[source] : 0;
 }
 
 template <typename T>
@@ -0,0 +1,65 @@
+//===-- bfeattacks/Streaming.h - Streaming candidate stages ----*- C++ -*--===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains the visitor receiving candidates from
+/// SingleRecord::stream_traversal as they are found, along with generic stages
+/// that can be chained in front of one. Stages for the filters live alongside
+/// the filters themselves.
+///
+//===----------------------------------------------------------------------===//
+#ifndef BFEATTACKS_STREAMING_H_INCLUDED
+#define BFEATTACKS_STREAMING_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "adt/CandidateSet.h"
+#include "graph/Traversals.h"
+
+namespace bfeattacks {
+/// Receives candidates as simplified strings. Either callback may be left
+/// empty
+struct CandidateVisitor {
+  /// Called with each partial candidate as the search extends it. Every
+  /// candidate found below it starts with it
+  std::function<graph::Visit(const std::string &)> extend;
+  /// Called with each complete candidate
+  std::function<graph::Visit(const std::string &)> found;
+};
+
+/// Calls next.extend if set
+graph::Visit pass_extend(const CandidateVisitor &next,
+                         const std::string &prefix);
+/// Calls next.found if set
+graph::Visit pass_found(const CandidateVisitor &next,
+                        const std::string &candidate);
+
+/// Stores each candidate in out, which must outlive the traversal
+CandidateVisitor collect_stage(std::vector<std::string> &out);
+/// Adds each candidate to out, which must outlive the traversal. Repeats are
+/// only stored once
+CandidateVisitor collect_set_stage(adt::CandidateSet &out);
+
+/// Passes the first n candidates to next, then stops the traversal
+CandidateVisitor limit_stage(std::size_t n, CandidateVisitor next);
+}
+
+#endif
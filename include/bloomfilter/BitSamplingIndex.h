@@ -0,0 +1,110 @@
+//===-- bloomfilter/BitSamplingIndex.h - LSH over filters -------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file defines BitSamplingIndex, a locality sensitive hashing
+/// index for finding filters similar to a query without comparing it against
+/// all of them.
+///
+//===----------------------------------------------------------------------===//
+#ifndef BLOOMFILTER_BITSAMPLINGINDEX_H_INCLUDED
+#define BLOOMFILTER_BITSAMPLINGINDEX_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bloomfilter/FilterArray.h"
+#include "concurrent/ThreadPool.h"
+
+namespace bloomfilter {
+/// Bit sampling LSH over the filters of a FilterArray.
+///
+/// Each of tables tables samples the same bits positions of every filter,
+/// and filters whose samples agree land in the same bucket. Filters at
+/// Hamming distance d from a query agree on one position with probability
+/// p = 1 - d / m, so share a bucket in at least one table with probability
+/// 1 - (1 - p^bits)^tables. More bits make buckets more selective, and more
+/// tables raise the recall; recall() gives the trade off for a distance.
+/// Candidates are then checked exactly against the Dice threshold.
+///
+/// Each table is a sorted array of keys, so it is built by sorting and
+/// searched by binary search, and is stored as is.
+class BitSamplingIndex {
+public:
+  struct Parameters {
+    /// Positions sampled per table, at most 64
+    unsigned int bits = 24;
+    unsigned int tables = 16;
+    std::uint64_t seed = 5489u;
+  };
+
+  BitSamplingIndex();
+  /// Indexes filters, building the tables in parallel over pool
+  BitSamplingIndex(FilterArray filters_, const Parameters &parameters_,
+                   concurrent::ThreadPoolSimple &pool);
+
+  BitSamplingIndex(BitSamplingIndex &&) = default;
+  BitSamplingIndex &operator=(BitSamplingIndex &&) = default;
+  BitSamplingIndex(const BitSamplingIndex &) = delete;
+  BitSamplingIndex &operator=(const BitSamplingIndex &) = delete;
+
+  /// Appends to hits the indexed filters sharing a bucket with query whose
+  /// Dice coefficient with it is at least threshold, in order of index.
+  /// Returns the number of distinct candidates checked
+  std::size_t query(const boost::dynamic_bitset<> &query, double threshold,
+                    std::vector<FilterArray::Hit> &hits) const;
+
+  /// Probability that a filter at Hamming distance hamming from a query is a
+  /// candidate for it
+  double recall(std::size_t hamming) const;
+
+  const FilterArray &filters() const { return indexed; }
+  const Parameters &parameters() const { return params; }
+  std::size_t size() const { return indexed.size(); }
+
+  /// Stored as magic "BSI1", the parameters as uint64, the sampled positions
+  /// as uint32, each table's keys then ids, and finally the filters as written
+  /// by FilterArray::write
+  void write(std::ostream &out) const;
+  /// Replaces this index by one written by write. Returns false, leaving it
+  /// empty, if in does not hold one
+  bool read(std::istream &in);
+
+private:
+  struct Table {
+    std::vector<std::uint32_t> positions;
+    // Sorted by key, with the filter each key came from
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> ids;
+  };
+
+  static std::uint64_t key(const Table &table, const util::Word *words);
+  static void build(Table &table, const FilterArray &filters);
+
+  Parameters params;
+  FilterArray indexed;
+  std::vector<Table> tables;
+};
+}
+
+#endif
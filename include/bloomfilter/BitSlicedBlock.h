@@ -0,0 +1,138 @@
+//===-- bloomfilter/BitSlicedBlock.h - Transposed filters -------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file defines BitSlicedBlock, which stores a block of filters
+/// transposed so a member can be tested against all of them at once, and
+/// potential_members_batch built on it.
+///
+//===----------------------------------------------------------------------===//
+#ifndef BLOOMFILTER_BITSLICEDBLOCK_H_INCLUDED
+#define BLOOMFILTER_BITSLICEDBLOCK_H_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "adt/AdaptiveBitset.h"
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+namespace bloomfilter {
+/// Up to records filters of length m, stored as one slice per bit position
+/// holding that bit of every filter, so filter r is bit r % 64 of word r / 64
+/// of each slice
+class BitSlicedBlock {
+public:
+  BitSlicedBlock(unsigned int m_, std::size_t records);
+
+  /// Appends bits, which must have length m, returning its record number
+  std::size_t add(const boost::dynamic_bitset<> &bits);
+  /// Appends the words of a length m bitset, whose bits past m are zero
+  std::size_t add(const util::BitsetBlocks &bits);
+  /// Appends a length m bitset from the positions it has set, as it may have
+  /// no words to give
+  std::size_t add(const adt::AdaptiveBitset &bits);
+
+  std::size_t size() const { return count; }
+  /// Words in each slice, and in each mask below
+  std::size_t slice_words() const { return words; }
+
+  /// Sets out[0, slice_words()) to the records with every one of positions
+  /// set. Returns false, with out unspecified, if there are none
+  bool all_set(const std::vector<unsigned int> &positions,
+               util::Word *out) const;
+
+private:
+  unsigned int m;
+  std::size_t capacity;
+  std::size_t words;
+  std::size_t count;
+  std::vector<util::Word> slices;
+};
+
+namespace detail {
+// What BitSlicedBlock::add takes for a filter's storage: its words where it
+// has them, otherwise the storage itself
+template <typename Bits> util::BitsetBlocks slice_source(const Bits &bits) {
+  // Found by argument dependent lookup for the other bitsets
+  using util::blocks;
+  return blocks(bits);
+}
+inline const adt::AdaptiveBitset &
+slice_source(const adt::AdaptiveBitset &bits) {
+  return bits;
+}
+}
+
+/// Finds the potential members of every filter over alphabet at once and
+/// seeds each filter's potential_members cache with them. Each member is
+/// hashed once and tested against all of the filters with one AND per
+/// position per 64 filters. Members are hashed with the first filter, so all
+/// of the filters must share its length and hashes, keys included, as when
+/// built from one key set.
+template <typename BF>
+void potential_members_batch(const std::vector<const BF *> &filters,
+                             const std::string &alphabet);
+}
+
+template <typename BF>
+void bloomfilter::potential_members_batch(
+    const std::vector<const BF *> &filters, const std::string &alphabet) {
+  if (filters.empty())
+    return;
+
+#ifndef NDEBUG
+  const std::vector<std::string> names = filters.front()->hash_names();
+  for (const BF *bf : filters)
+    assert(bf->length() == filters.front()->length() &&
+           bf->hash_count() == filters.front()->hash_count() &&
+           bf->hash_names() == names &&
+           "Batched filters must share their length and hashes");
+#endif
+
+  BitSlicedBlock block(filters.front()->length(), filters.size());
+  for (const BF *bf : filters)
+    block.add(detail::slice_source(bf->raw()));
+
+  typedef typename BF::insertion_policy::processor processor;
+  typedef typename processor::all_iterator iterator;
+
+  std::vector<std::vector<std::string> > members(filters.size());
+  std::vector<util::Word> mask(block.slice_words());
+  for (iterator i = processor::all_begin(alphabet),
+                e = processor::all_end(alphabet);
+       i != e; ++i) {
+    const std::string member = *i;
+    if (!block.all_set(filters.front()->member_positions(member), mask.data()))
+      continue;
+
+    for (std::size_t w = 0; w < mask.size(); ++w)
+      for (util::Word bits = mask[w]; bits != 0; bits &= bits - 1)
+        members[w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))]
+            .push_back(member);
+  }
+
+  for (std::size_t r = 0; r < filters.size(); ++r)
+    filters[r]->seed_potential_members(alphabet, std::move(members[r]));
+}
+
+#endif
@@ -23,6 +23,10 @@
 #ifndef BLOOMFILTER_BLOOMFILTER_H_INCLUDED
 #define BLOOMFILTER_BLOOMFILTER_H_INCLUDED
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
@@ -33,25 +37,94 @@
 
 #include "HashSet.h"
 #include "InsertionPolicy.h"
+#include "adt/AdaptiveBitset.h"
+#include "adt/AlignedBitset.h"
+#include "adt/FixedBitset.h"
+#include "adt/InlineBitTuple.h"
+#include "util/BitsetBlocks.h"
 
 namespace bloomfilter {
-/// Basic templated Bloom filter. Configurable based on the hashes and how
-/// things are inserted. It also tracks what was inserted in the filter
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries = false>
+namespace detail {
+// Bits set in both a and b, counted over their words. Storage without words
+// overloads this in its own namespace, where argument dependent lookup finds
+// it first
+template <typename Storage>
+std::size_t intersection_count(const Storage &a, const Storage &b) {
+  using util::blocks;
+  const util::BitsetBlocks a_words = blocks(a);
+  const util::BitsetBlocks b_words = blocks(b);
+  assert(a_words.size == b_words.size);
+  return util::count_and(a_words.data, b_words.data, a_words.size);
+}
+
+// Merges the sorted ids added into the sorted ids, keeping names, the
+// universe entries of ids, beside them
+inline void merge_members(std::vector<unsigned int> &ids,
+                          std::vector<std::string> &names,
+                          const std::vector<unsigned int> &added,
+                          const std::vector<std::string> &universe) {
+  if (added.empty())
+    return;
+
+  std::vector<unsigned int> merged_ids;
+  std::vector<std::string> merged_names;
+  merged_ids.reserve(ids.size() + added.size());
+  merged_names.reserve(ids.size() + added.size());
+
+  std::size_t i = 0, j = 0;
+  while (i < ids.size() || j < added.size()) {
+    if (j == added.size() || (i < ids.size() && ids[i] < added[j])) {
+      merged_ids.push_back(ids[i]);
+      merged_names.push_back(std::move(names[i++]));
+    } else {
+      merged_ids.push_back(added[j]);
+      merged_names.push_back(universe[added[j++]]);
+    }
+  }
+
+  ids.swap(merged_ids);
+  names.swap(merged_names);
+}
+}
+
+/// Basic templated Bloom filter. Configurable based on the hashes, how
+/// things are inserted and the bitset holding its bits. It also tracks what
+/// was inserted in the filter.
+///
+/// What was inserted and the caches for attacking the filter live in a
+/// separate object that is only allocated once used, so a filter that only
+/// has things inserted and compared is just its parameters and bits.
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries = false,
+          typename Storage = boost::dynamic_bitset<> >
 class BloomFilter {
 public:
-  template <typename A, typename B, bool C>
+  typedef Hashes hash_set;
+  typedef InsertionPolicy insertion_policy;
+
+  template <typename A, typename B, bool C, typename D>
   friend std::ostream &operator<<(std::ostream &out,
-                                  const BloomFilter<A, B, C> &bf);
-  template <typename A, typename B, bool C>
+                                  const BloomFilter<A, B, C, D> &bf);
+  template <typename A, typename B, bool C, typename D>
   friend std::pair<boost::dynamic_bitset<>::size_type,
                    boost::dynamic_bitset<>::size_type>
-  dice_coefficient(BloomFilter<A, B, C> a, BloomFilter<A, B, C> b);
+  dice_coefficient(const BloomFilter<A, B, C, D> &a,
+                   const BloomFilter<A, B, C, D> &b);
 
   BloomFilter(unsigned int m_, Hashes &hashes_)
-      : hashes(hashes_), contents(m_), m(m_), policy(), real_inserted(),
-        real_members(), all_alphabet(""), all_members(),
-        all_members_valid(false), fake_members(), fake_members_valid(false) {}
+      : hashes(hashes_), contents(m_), m(m_), policy(), extra() {}
+
+  BloomFilter(const BloomFilter &rhs)
+      : hashes(rhs.hashes), contents(rhs.contents), m(rhs.m),
+        policy(rhs.policy),
+        extra(rhs.extra ? new Extras(*rhs.extra) : nullptr) {}
+  BloomFilter(BloomFilter &&) = default;
+  /// Deep copies rhs, its caches included. Copies first, so this is left as
+  /// it was if the copy fails
+  BloomFilter &operator=(const BloomFilter &rhs) {
+    BloomFilter copy(rhs);
+    return *this = std::move(copy);
+  }
+  BloomFilter &operator=(BloomFilter &&) = default;
 
   /// Inserts string in into Bloom Filter according to the insertion policy
   void insert(const std::string &in);
@@ -63,25 +136,52 @@ public:
   /// Checks whether blooms filter contains in and only in
   bool contains_exactly(const std::string &in) const;
 
+  /// Returns the bits set by member alone, where member is a single item
+  /// produced by the insertion policy (e.g. one n-gram)
+  Storage member_bits(const std::string &member) const;
+
+  /// Returns the positions member sets, in hash order and possibly repeated
+  std::vector<unsigned int> member_positions(const std::string &member) const;
+
+  /// Splits in into the members the insertion policy would insert
+  typename InsertionPolicy::processor members(const std::string &in) const {
+    return policy.process(in);
+  }
+
   /// Returns a vector of potential members using the specified alphabet
   const std::vector<std::string> &
   potential_members(const std::string &alphabet) const;
 
+  /// Stores members as what potential_members(alphabet) would return, for
+  /// when they were found some other way, such as for many filters at once
+  void seed_potential_members(const std::string &alphabet,
+                              std::vector<std::string> members) const;
+
   /// Returns just the false positive members. Requires potential_members to
   /// be
   /// called first
   const std::vector<std::string> &false_members() const;
 
   /// Returns a set of what was actually inserted
-  const std::set<std::string> &true_members() const { return real_members; }
+  const std::set<std::string> &true_members() const {
+    static const std::set<std::string> none;
+    return extra ? extra->real_members : none;
+  }
 
   /// Returns a vector of the strings inserted
   const std::vector<std::string> &actual_inserted() const {
-    return real_inserted;
+    static const std::vector<std::string> none;
+    return extra ? extra->real_inserted : none;
   }
 
   /// Direct access to the underlying bitset
-  const boost::dynamic_bitset<> &raw() const { return contents; }
+  const Storage &raw() const { return contents; }
+
+  /// The words of the underlying bitset, for whole word comparisons
+  util::BitsetBlocks words() const {
+    using util::blocks;
+    return blocks(contents);
+  }
 
   /// The number of bits that are set
   boost::dynamic_bitset<>::size_type count() const { return contents.count(); }
@@ -92,24 +192,72 @@ public:
   /// Returns the number of hashes
   unsigned int hash_count() const { return hashes.count(); }
 
+  /// Returns the names of the hashes, keys included
+  std::vector<std::string> hash_names() const { return hashes.names(); }
+
 private:
+  // Every member the alphabet makes, numbered in the order potential_members
+  // finds them, with the distinct positions each has and, per bit, the
+  // members having it. Depends only on the alphabet, hashes and m, so copies
+  // of a filter share it. The members of bit p are
+  // ids[offsets[p], offsets[p + 1]), so an empty bit costs one offset
+  struct MemberIndex {
+    std::string alphabet;
+    std::vector<std::string> universe;
+    std::vector<unsigned int> widths;
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> ids;
+  };
+
+  // Tracking of what was inserted, and caches of what could have been
+  struct Extras {
+    std::vector<std::string> real_inserted;
+    std::set<std::string> real_members;
+    std::string all_alphabet;
+    std::vector<std::string> all_members;
+    bool all_members_valid = false;
+    std::vector<std::string> fake_members;
+    bool fake_members_valid = false;
+
+    // Universe ids of all_members and fake_members, unknown when seeded
+    std::vector<unsigned int> all_ids;
+    std::vector<unsigned int> fake_ids;
+    bool all_ids_valid = false;
+
+    // Per member of the index, how many of its positions are still unset, so
+    // an insert only visits the members of the bits it sets
+    std::shared_ptr<const MemberIndex> index;
+    std::vector<unsigned int> missing;
+    bool missing_valid = false;
+  };
+
+  // Builds the index for all_alphabet if needed, and counts missing from the
+  // current contents
+  void index_members(Extras &x) const;
+
+  // Updates all_members, and fake_members if valid, for the newly set bits
+  // and the newly real members of an insert
+  void update_members(Extras &x, const std::vector<unsigned int> &set_bits,
+                      const std::vector<std::string> &now_real) const;
+
+  Extras &extras() const {
+    if (!extra)
+      extra.reset(new Extras());
+    return *extra;
+  }
+
   Hashes hashes;
-  boost::dynamic_bitset<> contents;
+  Storage contents;
   unsigned int m;
   InsertionPolicy policy;
-  std::vector<std::string> real_inserted;
-  std::set<std::string> real_members;
-  mutable std::string all_alphabet;
-  mutable std::vector<std::string> all_members;
-  mutable bool all_members_valid;
-  mutable std::vector<std::string> fake_members;
-  mutable bool fake_members_valid;
+  mutable std::unique_ptr<Extras> extra;
 };
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
 std::ostream &operator<<(
     std::ostream &out,
-    const BloomFilter<Hashes, InsertionPolicy, TrackEntries> &bf) {
+    const BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage> &bf) {
   out << "BloomFilter:\n"
       << "Size (m) = " << bf.contents.size() << "\n"
       << "Hashes: " << bf.hashes << "\n"
@@ -122,9 +270,11 @@ std::ostream &operator<<(
   out << "\n";
 
   if (TrackEntries) {
-    out << "Actually Inserted(" << bf.real_inserted.size() << "): {";
-    for (std::vector<std::string>::const_iterator i = bf.real_inserted.begin(),
-                                                  e = bf.real_inserted.end();
+    const std::vector<std::string> &real_inserted = bf.actual_inserted();
+    const std::set<std::string> &real_members = bf.true_members();
+    out << "Actually Inserted(" << real_inserted.size() << "): {";
+    for (std::vector<std::string>::const_iterator i = real_inserted.begin(),
+                                                  e = real_inserted.end();
          i != e;) {
       out << *i;
 
@@ -132,9 +282,9 @@ std::ostream &operator<<(
         out << ", ";
     }
     out << "}\n"
-        << "Actual Members(" << bf.real_members.size() << "): {";
-    for (std::set<std::string>::const_iterator i = bf.real_members.begin(),
-                                               e = bf.real_members.end();
+        << "Actual Members(" << real_members.size() << "): {";
+    for (std::set<std::string>::const_iterator i = real_members.begin(),
+                                               e = real_members.end();
          i != e;) {
       out << *i;
 
@@ -143,10 +293,11 @@ std::ostream &operator<<(
     }
     out << "}\n";
 
-    if (bf.all_members_valid) {
-      out << "All(" << bf.all_members.size() << "): {";
-      for (std::vector<std::string>::const_iterator i = bf.all_members.begin(),
-                                                    e = bf.all_members.end();
+    if (bf.extra && bf.extra->all_members_valid) {
+      const std::vector<std::string> &all_members = bf.extra->all_members;
+      out << "All(" << all_members.size() << "): {";
+      for (std::vector<std::string>::const_iterator i = all_members.begin(),
+                                                    e = all_members.end();
            i != e;) {
         out << *i;
 
@@ -155,12 +306,10 @@ std::ostream &operator<<(
       }
       out << "}\n";
 
-      if (!bf.fake_members_valid)
-        bf.false_members();
-
-      out << "False positives(" << bf.fake_members.size() << "): {";
-      for (std::vector<std::string>::const_iterator i = bf.fake_members.begin(),
-                                                    e = bf.fake_members.end();
+      const std::vector<std::string> &fake_members = bf.false_members();
+      out << "False positives(" << fake_members.size() << "): {";
+      for (std::vector<std::string>::const_iterator i = fake_members.begin(),
+                                                    e = fake_members.end();
            i != e;) {
         out << *i;
 
@@ -182,14 +331,29 @@ std::ostream &operator<<(
   return out;
 }
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
-void BloomFilter<Hashes, InsertionPolicy, TrackEntries>::insert(
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+void BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::insert(
     const std::string &in) {
-  all_members_valid = false;
-  fake_members_valid = false;
-  if (TrackEntries)
-    real_inserted.push_back(in);
+  // Members already found are updated from the bits this sets, rather than
+  // found again over the whole alphabet
+  Extras *incremental =
+      extra && extra->all_members_valid && extra->all_ids_valid ? extra.get()
+                                                                : nullptr;
+  if (incremental && !incremental->missing_valid)
+    index_members(*incremental);
+  if (extra && !incremental) {
+    extra->all_members_valid = false;
+    extra->fake_members_valid = false;
+    extra->missing_valid = false;
+  }
+
+  Extras *tracked = TrackEntries ? &extras() : nullptr;
+  if (tracked)
+    tracked->real_inserted.push_back(in);
 
+  std::vector<unsigned int> set_bits;
+  std::vector<std::string> now_real;
   typename InsertionPolicy::processor ip = policy.process(in);
 
   for (typename InsertionPolicy::processor::iterator i = ip.begin(),
@@ -197,18 +361,24 @@ void BloomFilter<Hashes, InsertionPolicy, TrackEntries>::insert(
        i != e; ++i) {
     typename Hashes::processor hp = hashes.process(*i, m);
 
-    if (TrackEntries)
-      real_members.insert(*i);
+    if (tracked && tracked->real_members.insert(*i).second && incremental)
+      now_real.push_back(*i);
 
     for (typename Hashes::processor::iterator j = hp.begin(), f = hp.end();
          j != f; ++j) {
+      if (incremental && !contents.test(*j))
+        set_bits.push_back(*j);
       contents.set(*j);
     }
   }
+
+  if (incremental)
+    update_members(*incremental, set_bits, now_real);
 }
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
-bool BloomFilter<Hashes, InsertionPolicy, TrackEntries>::contains(
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+bool BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::contains(
     const std::string &in) const {
   typename InsertionPolicy::processor ip = policy.process(in);
 
@@ -227,11 +397,12 @@ bool BloomFilter<Hashes, InsertionPolicy, TrackEntries>::contains(
   return true;
 }
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
-bool BloomFilter<Hashes, InsertionPolicy, TrackEntries>::contains_exactly(
-    const std::string &in) const {
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+bool BloomFilter<Hashes, InsertionPolicy, TrackEntries,
+                 Storage>::contains_exactly(const std::string &in) const {
   typename InsertionPolicy::processor ip = policy.process(in);
-  boost::dynamic_bitset<> test_contents(contents.size());
+  Storage test_contents(contents.size());
 
   for (typename InsertionPolicy::processor::iterator i = ip.begin(),
                                                      e = ip.end();
@@ -247,23 +418,59 @@ bool BloomFilter<Hashes, InsertionPolicy, TrackEntries>::contains_exactly(
   return test_contents == contents;
 }
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+Storage
+BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::member_bits(
+    const std::string &member) const {
+  Storage bits(contents.size());
+  typename Hashes::processor hp = hashes.process(member, m);
+
+  for (typename Hashes::processor::iterator j = hp.begin(), f = hp.end();
+       j != f; ++j)
+    bits.set(*j);
+
+  return bits;
+}
+
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+std::vector<unsigned int>
+BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::member_positions(
+    const std::string &member) const {
+  std::vector<unsigned int> positions;
+  positions.reserve(hashes.count());
+  typename Hashes::processor hp = hashes.process(member, m);
+
+  for (typename Hashes::processor::iterator j = hp.begin(), f = hp.end();
+       j != f; ++j)
+    positions.push_back(*j);
+
+  return positions;
+}
+
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
 const std::vector<std::string> &
-BloomFilter<Hashes, InsertionPolicy, TrackEntries>::potential_members(
+BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::potential_members(
     const std::string &alphabet) const {
-  if (all_members_valid && all_alphabet == alphabet)
-    return all_members;
+  Extras &x = extras();
+  if (x.all_members_valid && x.all_alphabet == alphabet)
+    return x.all_members;
 
-  all_members.clear();
-  all_alphabet = alphabet;
-  fake_members_valid = false;
+  x.all_members.clear();
+  x.all_ids.clear();
+  x.all_alphabet = alphabet;
+  x.fake_members_valid = false;
+  x.missing_valid = false;
 
   typedef typename InsertionPolicy::processor processor;
   typedef typename InsertionPolicy::processor::all_iterator iterator;
 
+  unsigned int id = 0;
   for (iterator i = processor::all_begin(alphabet),
                 e = processor::all_end(alphabet);
-       i != e; ++i) {
+       i != e; ++i, ++id) {
     typename Hashes::processor hp = hashes.process(*i, m);
 
     bool contained = true;
@@ -275,66 +482,229 @@ BloomFilter<Hashes, InsertionPolicy, TrackEntries>::potential_members(
       }
     }
 
-    if (contained)
-      all_members.push_back(*i);
+    if (contained) {
+      x.all_members.push_back(*i);
+      x.all_ids.push_back(id);
+    }
   }
 
-  all_members_valid = true;
+  x.all_members_valid = true;
+  x.all_ids_valid = true;
 
-  return all_members;
+  return x.all_members;
 }
 
-template <typename Hashes, typename InsertionPolicy, bool TrackEntries>
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+void BloomFilter<Hashes, InsertionPolicy, TrackEntries,
+                 Storage>::seed_potential_members(
+    const std::string &alphabet, std::vector<std::string> members) const {
+  Extras &x = extras();
+  x.all_members = std::move(members);
+  x.all_alphabet = alphabet;
+  x.all_members_valid = true;
+  x.fake_members_valid = false;
+  x.all_ids_valid = false;
+  x.missing_valid = false;
+}
+
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+void BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::index_members(
+    Extras &x) const {
+  if (!x.index || x.index->alphabet != x.all_alphabet) {
+    std::shared_ptr<MemberIndex> index = std::make_shared<MemberIndex>();
+    index->alphabet = x.all_alphabet;
+    index->offsets.assign(m + 1, 0);
+
+    typedef typename InsertionPolicy::processor processor;
+    typedef typename InsertionPolicy::processor::all_iterator iterator;
+
+    // Every member's distinct positions in id order, counted per bit so they
+    // can then be sorted into place by bit
+    std::vector<unsigned int> member_at;
+    for (iterator i = processor::all_begin(x.all_alphabet),
+                  e = processor::all_end(x.all_alphabet);
+         i != e; ++i) {
+      index->universe.push_back(*i);
+
+      std::vector<unsigned int> positions = member_positions(*i);
+      std::sort(positions.begin(), positions.end());
+      positions.erase(std::unique(positions.begin(), positions.end()),
+                      positions.end());
+
+      index->widths.push_back(static_cast<unsigned int>(positions.size()));
+      for (unsigned int p : positions) {
+        member_at.push_back(p);
+        ++index->offsets[p + 1];
+      }
+    }
+
+    for (unsigned int p = 0; p < m; ++p)
+      index->offsets[p + 1] += index->offsets[p];
+    index->ids.resize(member_at.size());
+    std::vector<unsigned int> next(index->offsets.begin(),
+                                   index->offsets.end() - 1);
+    std::size_t at = 0;
+    for (unsigned int id = 0; id < index->widths.size(); ++id)
+      for (unsigned int j = 0; j < index->widths[id]; ++j)
+        index->ids[next[member_at[at++]]++] = id;
+
+    x.index = std::move(index);
+  }
+
+  const MemberIndex &index = *x.index;
+  x.missing = index.widths;
+  for (unsigned int p = 0; p < m; ++p) {
+    if (contents.test(p)) {
+      for (unsigned int j = index.offsets[p]; j < index.offsets[p + 1]; ++j)
+        --x.missing[index.ids[j]];
+    }
+  }
+  x.missing_valid = true;
+}
+
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
+void BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::
+    update_members(Extras &x, const std::vector<unsigned int> &set_bits,
+                   const std::vector<std::string> &now_real) const {
+  const MemberIndex &index = *x.index;
+  const std::vector<std::string> &universe = index.universe;
+
+  std::vector<unsigned int> found;
+  for (unsigned int p : set_bits) {
+    for (unsigned int j = index.offsets[p]; j < index.offsets[p + 1]; ++j) {
+      const unsigned int id = index.ids[j];
+      if (--x.missing[id] == 0)
+        found.push_back(id);
+    }
+  }
+  std::sort(found.begin(), found.end());
+  detail::merge_members(x.all_ids, x.all_members, found, universe);
+
+  if (!x.fake_members_valid)
+    return;
+
+  // Members inserted now were false positives if they were already members
+  if (!now_real.empty()) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < x.fake_ids.size(); ++i) {
+      if (std::find(now_real.begin(), now_real.end(), x.fake_members[i]) ==
+          now_real.end()) {
+        if (kept != i) {
+          x.fake_ids[kept] = x.fake_ids[i];
+          x.fake_members[kept] = std::move(x.fake_members[i]);
+        }
+        ++kept;
+      }
+    }
+    x.fake_ids.resize(kept);
+    x.fake_members.resize(kept);
+  }
+
+  std::vector<unsigned int> fake;
+  for (unsigned int id : found) {
+    if (x.real_members.find(universe[id]) == x.real_members.end())
+      fake.push_back(id);
+  }
+  detail::merge_members(x.fake_ids, x.fake_members, fake, universe);
+}
+
+template <typename Hashes, typename InsertionPolicy, bool TrackEntries,
+          typename Storage>
 const std::vector<std::string> &
-BloomFilter<Hashes, InsertionPolicy, TrackEntries>::false_members() const {
+BloomFilter<Hashes, InsertionPolicy, TrackEntries, Storage>::false_members()
+    const {
   // If all members is not valid, we can't calculate false positives
-  assert(all_members_valid);
+  assert(extra && extra->all_members_valid);
+  Extras &x = *extra;
 
-  if (fake_members_valid)
-    return fake_members;
+  if (x.fake_members_valid)
+    return x.fake_members;
 
-  fake_members.clear();
+  x.fake_members.clear();
+  x.fake_ids.clear();
 
-  for (std::vector<std::string>::const_iterator i = all_members.begin(),
-                                                e = all_members.end();
-       i != e; ++i) {
-    if (real_members.find(*i) == real_members.end())
-      fake_members.push_back(*i);
+  for (std::size_t i = 0; i < x.all_members.size(); ++i) {
+    if (x.real_members.find(x.all_members[i]) == x.real_members.end()) {
+      x.fake_members.push_back(x.all_members[i]);
+      if (x.all_ids_valid)
+        x.fake_ids.push_back(x.all_ids[i]);
+    }
   }
 
-  fake_members_valid = true;
+  x.fake_members_valid = true;
 
-  return fake_members;
+  return x.fake_members;
 }
 
-template <typename A, typename B, bool C>
+template <typename A, typename B, bool C, typename D>
 std::pair<boost::dynamic_bitset<>::size_type,
           boost::dynamic_bitset<>::size_type>
-dice_coefficient(BloomFilter<A, B, C> a, BloomFilter<A, B, C> b) {
+dice_coefficient(const BloomFilter<A, B, C, D> &a,
+                 const BloomFilter<A, B, C, D> &b) {
   // Can only reasonably compare two bitsets of the same size
   assert(a.contents.size() == b.contents.size());
 
   // Calculate as:
   // 2 * | a \intersect b | / (|a| + |b|)
   // where |*| is number of bits set
+  using detail::intersection_count;
+  boost::dynamic_bitset<>::size_type numerator =
+      2 * intersection_count(a.contents, b.contents);
+  boost::dynamic_bitset<>::size_type denominator = a.count() + b.count();
 
-  boost::dynamic_bitset<>::size_type intersection = 0;
+  return std::make_pair(numerator, denominator);
+}
 
-  for (boost::dynamic_bitset<>::size_type i = 0, e = a.contents.size(); i != e;
-       ++i) {
-    if (a.contents[i] && b.contents[i])
-      ++intersection;
-  }
+/// Returns the Jaccard coefficient of a and b as a numerator and denominator:
+/// | a \intersect b | / | a \union b |
+template <typename A, typename B, bool C, typename D>
+std::pair<boost::dynamic_bitset<>::size_type,
+          boost::dynamic_bitset<>::size_type>
+jaccard_coefficient(const BloomFilter<A, B, C, D> &a,
+                    const BloomFilter<A, B, C, D> &b) {
+  assert(a.length() == b.length());
 
-  boost::dynamic_bitset<>::size_type numerator = 2 * intersection;
-  boost::dynamic_bitset<>::size_type denominator =
-      a.contents.count() + b.contents.count();
+  using detail::intersection_count;
+  boost::dynamic_bitset<>::size_type intersection =
+      intersection_count(a.raw(), b.raw());
+  boost::dynamic_bitset<>::size_type both = a.count() + b.count();
 
-  return std::make_pair(numerator, denominator);
+  return std::make_pair(intersection, both - intersection);
 }
 
 typedef BloomFilter<HashSetPair, InsertionBigramWithSentinel, true>
 BloomFilterStandard;
+
+/// BloomFilterStandard with its bits in whole, cache line aligned words
+typedef BloomFilter<HashSetPair, InsertionBigramWithSentinel, true,
+                    adt::AlignedBitset> BloomFilterAligned;
+
+/// BloomFilterStandard with its bits inline for m up to 1024, so building one
+/// allocates nothing for the bits
+typedef BloomFilter<HashSetPair, InsertionBigramWithSentinel, true,
+                    adt::InlineBitTuple<16> > BloomFilterInline;
+
+/// BloomFilterStandard with m and k fixed at compile time, so hash positions
+/// are found with constant remainders and the bits live in the filter. Build
+/// it from M and a HashSetPairFixed<M, K>(K)
+template <unsigned int M, unsigned int K>
+using FixedBloomFilter =
+    BloomFilter<HashSetPairFixed<M, K>, InsertionBigramWithSentinel, true,
+                adt::FixedBitset<M> >;
+
+/// BloomFilterStandard for very large m with few bits set, keeping the bits
+/// as positions until that would take more room than words
+typedef BloomFilter<HashSetPair, InsertionBigramWithSentinel, true,
+                    adt::AdaptiveBitset> BloomFilterSparse;
+
+/// BloomFilterStandard with all k bits of an n-gram in one 512 bit block.
+/// The bits are cache line aligned, so each block is one line. Build it from
+/// a HashSetBlocked
+typedef BloomFilter<HashSetBlocked, InsertionBigramWithSentinel, true,
+                    adt::AlignedBitset> BloomFilterBlocked;
 }
 
 #endif
@@ -0,0 +1,139 @@
+//===-- bloomfilter/ExactMatcher.h - Batched exact matching -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file defines ExactMatcher, which answers
+/// BloomFilter::contains_exactly for many candidates against one filter
+///
+//===----------------------------------------------------------------------===//
+#ifndef BLOOMFILTER_EXACTMATCHER_H_INCLUDED
+#define BLOOMFILTER_EXACTMATCHER_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+namespace bloomfilter {
+/// Checks candidates against a single Bloom filter the way contains_exactly
+/// does, reusing work between them.
+///
+/// The positions of each member (e.g. n-gram) are hashed once and remembered,
+/// along with whether they all lie in the filter. A candidate is rejected at
+/// its first member setting a bit the filter lacks. Otherwise its bits are a
+/// subset of the filter's, so it matches exactly when it sets as many bits as
+/// the filter has. Bits are gathered in a scratch bitset kept between calls,
+/// and only the bits touched are cleared afterwards.
+///
+/// bf must outlive the matcher and not change while it is in use.
+template <typename BF> class ExactMatcher {
+public:
+  explicit ExactMatcher(const BF &bf_)
+      : bf(bf_), target(bf_.count()), memo(), scratch(bf_.length()),
+        touched() {}
+
+  /// Same as bf.contains_exactly(candidate)
+  bool matches(const std::string &candidate);
+
+  /// Removes the candidates bf does not contain exactly, keeping the order of
+  /// the rest
+  void retain_matches(std::vector<std::string> &candidates);
+
+  /// Number of distinct members hashed so far
+  std::size_t memo_size() const { return memo.size(); }
+
+private:
+  struct Member {
+    std::vector<unsigned int> positions;
+    bool in_filter;
+  };
+
+  const Member &lookup(const std::string &member);
+
+  const BF &bf;
+  const std::size_t target;
+  std::unordered_map<std::string, Member> memo;
+  boost::dynamic_bitset<> scratch;
+  std::vector<unsigned int> touched;
+};
+}
+
+template <typename BF>
+const typename bloomfilter::ExactMatcher<BF>::Member &
+bloomfilter::ExactMatcher<BF>::lookup(const std::string &member) {
+  auto found = memo.find(member);
+  if (found != memo.end())
+    return found->second;
+
+  Member entry{ bf.member_positions(member), true };
+  const auto &contents = bf.raw();
+  for (const unsigned int p : entry.positions) {
+    if (!contents.test(p)) {
+      // Only whether it is absent matters from here on
+      entry.positions.clear();
+      entry.in_filter = false;
+      break;
+    }
+  }
+
+  return memo.emplace(member, std::move(entry)).first->second;
+}
+
+template <typename BF>
+bool bloomfilter::ExactMatcher<BF>::matches(const std::string &candidate) {
+  auto ip = bf.members(candidate);
+  bool contained = true;
+
+  for (auto i = ip.begin(), e = ip.end(); i != e; ++i) {
+    const Member &member = lookup(*i);
+    if (!member.in_filter) {
+      contained = false;
+      break;
+    }
+
+    for (const unsigned int p : member.positions) {
+      if (!scratch.test(p)) {
+        scratch.set(p);
+        touched.push_back(p);
+      }
+    }
+  }
+
+  const bool exact = contained && touched.size() == target;
+
+  for (const unsigned int p : touched)
+    scratch.reset(p);
+  touched.clear();
+
+  return exact;
+}
+
+template <typename BF>
+void bloomfilter::ExactMatcher<BF>::retain_matches(
+    std::vector<std::string> &candidates) {
+  candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                  [this](const std::string &candidate) {
+                                    return !matches(candidate);
+                                  }),
+                   candidates.end());
+}
+
+#endif
@@ -0,0 +1,101 @@
+//===-- bloomfilter/FilterArray.h - Contiguous filter storage ---*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file defines FilterArray, which stores many equal length
+/// filters back to back so one query can be compared against all of them
+///
+//===----------------------------------------------------------------------===//
+#ifndef BLOOMFILTER_FILTERARRAY_H_INCLUDED
+#define BLOOMFILTER_FILTERARRAY_H_INCLUDED
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+namespace bloomfilter {
+/// Many filters of length m, each padded to a whole number of cache lines and
+/// stored back to back with its bit count, for Dice coefficients of one query
+/// against all of them
+class FilterArray {
+public:
+  typedef std::pair<std::size_t, std::size_t> Ratio;
+
+  struct Hit {
+    std::size_t index;
+    std::size_t numerator;
+    std::size_t denominator;
+  };
+
+  explicit FilterArray(unsigned int m_);
+
+  /// Appends bits, which must have length m, returning its index
+  std::size_t add(const boost::dynamic_bitset<> &bits);
+  /// Appends the words of a length m bitset, whose bits past m are zero
+  std::size_t add(const util::BitsetBlocks &bits);
+  /// Appends the contents of a BloomFilter of length m
+  template <typename BF> std::size_t add_filter(const BF &bf) {
+    return add(bf.words());
+  }
+
+  std::size_t size() const { return counts.size(); }
+  unsigned int length() const { return m; }
+  /// Bits set in filter i
+  std::size_t count(std::size_t i) const { return counts[i]; }
+  /// The words of filter i, zero padded to row_words()
+  const util::Word *row(std::size_t i) const { return &words[i * stride]; }
+  std::size_t row_words() const { return stride; }
+
+  /// Dice coefficient of query and filter i, as 2|q & f| over |q| + |f|
+  Ratio dice(const boost::dynamic_bitset<> &query, std::size_t i) const;
+  /// Dice coefficients of query against every filter, in order
+  void dice_all(const boost::dynamic_bitset<> &query,
+                std::vector<Ratio> &out) const;
+  /// Appends to hits the filters whose Dice coefficient with query is at least
+  /// threshold, in order. Filters whose bit counts alone rule them out are
+  /// skipped without comparing their words
+  void dice_at_least(const boost::dynamic_bitset<> &query, double threshold,
+                     std::vector<Hit> &hits) const;
+
+  /// Stored as magic "FAR1", then m and the number of filters as uint64, then
+  /// each padded row of words in host byte order
+  void write(std::ostream &out) const;
+  /// Replaces this array by one written by write. Returns false, leaving it
+  /// empty, if in does not hold one
+  bool read(std::istream &in);
+
+private:
+  // Copies query into a zero padded row
+  std::vector<util::Word> pad(const boost::dynamic_bitset<> &query) const;
+
+  unsigned int m;
+  // Words per filter, a multiple of a 64 byte cache line
+  std::size_t stride;
+  std::vector<util::Word> words;
+  std::vector<std::size_t> counts;
+};
+}
+
+#endif
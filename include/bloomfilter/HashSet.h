@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <ostream>
@@ -111,6 +112,134 @@ private:
   const unsigned int h2;
 };
 
+// A blocked variant of HashSetIteratorPair (Putze, Sanders&Singler 2007):
+// the first hash picks one 512 bit block (one cache line) and the k positions
+// are double hashed inside it, so every n-gram touches a single line. The last
+// block is shorter when m isn't a multiple of 512, so the stride is chosen
+// coprime to the width of the block it lands in, which keeps the positions
+// distinct for k up to that width
+class HashSetIteratorBlocked
+    : public std::iterator<std::input_iterator_tag, std::vector<byte> > {
+public:
+  static const unsigned int blockBits = 512;
+
+  friend bool operator==(const HashSetIteratorBlocked &lhs,
+                         const HashSetIteratorBlocked &rhs);
+  friend bool operator!=(const HashSetIteratorBlocked &lhs,
+                         const HashSetIteratorBlocked &rhs);
+
+  HashSetIteratorBlocked(
+      const std::vector<std::unique_ptr<hash::HashFunction> > &hashes_,
+      const std::string &in_, int index_, unsigned int m_, unsigned int k_)
+      : hashes(hashes_), in(in_), index(index_), m(m_), k(k_),
+        h1((hashes[0]->calculate(in)) % m), base(h1 / blockBits * blockBits),
+        width(m - base < blockBits ? m - base : blockBits), a(h1 - base),
+        b(stride((hashes[1]->calculate(in)) % width, width)) {
+    assert(hashes.size() == 2);
+    assert(m != 0);
+    assert(k != 0);
+  }
+
+  HashSetIteratorBlocked(const HashSetIteratorBlocked &rhs)
+      : hashes(rhs.hashes), in(rhs.in), index(rhs.index), m(rhs.m), k(rhs.k),
+        h1(rhs.h1), base(rhs.base), width(rhs.width), a(rhs.a), b(rhs.b) {}
+
+  HashSetIteratorBlocked &operator++();
+  HashSetIteratorBlocked &operator++(int);
+  unsigned int operator*();
+
+  const static std::string name() { return "Blocked"; }
+
+private:
+  // A stride in [1, width) coprime to width, found from h < width, or 1 for a
+  // block of one bit
+  static unsigned int stride(unsigned int h, unsigned int width);
+
+  const std::vector<std::unique_ptr<hash::HashFunction> > &hashes;
+  const std::string &in;
+  int index;
+  const unsigned int m;
+  const unsigned int k;
+  const unsigned int h1;
+  const unsigned int base;
+  const unsigned int width;
+  const unsigned int a;
+  const unsigned int b;
+};
+
+bool operator==(const HashSetIteratorBlocked &lhs,
+                const HashSetIteratorBlocked &rhs);
+bool operator!=(const HashSetIteratorBlocked &lhs,
+                const HashSetIteratorBlocked &rhs);
+
+// The positions of HashSetIteratorPair for a filter of M bits and K hashes
+// fixed at compile time. Each remainder is by a constant, so compiles to
+// multiplies, and the positions are all found up front in a loop of known
+// length, which the compiler unrolls
+template <unsigned int M, unsigned int K> class HashSetIteratorPairFixed
+    : public std::iterator<std::input_iterator_tag, unsigned int> {
+public:
+  static_assert(M != 0, "Filter needs at least one bit");
+  static_assert(K != 0, "Filter needs at least one hash");
+
+  explicit HashSetIteratorPairFixed(const unsigned int *position_)
+      : position(position_) {}
+
+  HashSetIteratorPairFixed &operator++() {
+    ++position;
+    return *this;
+  }
+  unsigned int operator*() const { return *position; }
+
+  friend bool operator==(const HashSetIteratorPairFixed &lhs,
+                         const HashSetIteratorPairFixed &rhs) {
+    return lhs.position == rhs.position;
+  }
+  friend bool operator!=(const HashSetIteratorPairFixed &lhs,
+                         const HashSetIteratorPairFixed &rhs) {
+    return lhs.position != rhs.position;
+  }
+
+  const static std::string name() { return "Pair"; }
+
+private:
+  const unsigned int *position;
+};
+
+template <unsigned int M, unsigned int K> class HashSetProcessorPairFixed {
+public:
+  typedef HashSetIteratorPairFixed<M, K> iterator;
+
+  HashSetProcessorPairFixed(
+      const std::vector<std::unique_ptr<hash::HashFunction> > &hashes,
+      const std::string &in, unsigned int m, unsigned int k) {
+    assert(hashes.size() == 2);
+    assert(m == M && "m is fixed at compile time");
+    assert(k == K && "k is fixed at compile time");
+    (void)m;
+    (void)k;
+
+    const unsigned int h1 = remainder(hashes[0]->calculate(in));
+    const unsigned int h2 = remainder(hashes[1]->calculate(in));
+    for (unsigned int i = 0; i < K; ++i)
+      positions[i] = (h1 + h2 * i) % M;
+  }
+
+  iterator begin() const { return iterator(positions); }
+  iterator end() const { return iterator(positions + K); }
+
+private:
+  // The big endian number in digest modulo M, a byte at a time
+  static unsigned int remainder(const std::vector<byte> &digest) {
+    std::uint64_t r = 0;
+    for (const byte b : digest)
+      r = ((r << 8) | b) % M;
+    return static_cast<unsigned int>(r);
+  }
+
+  unsigned int positions[K];
+};
+
 template <typename Iterator> class HashSetProcessor {
 public:
   typedef Iterator iterator;
@@ -152,6 +281,7 @@ public:
   HashSet& operator=(HashSet&& other) {
     k = other.k;
     std::swap(functions, other.functions);
+    return *this;
   }
 
   HashSet &add(hash::Hashes hash);
@@ -221,6 +351,10 @@ std::vector<std::string> HashSet<Processor>::names() const {
 
 typedef HashSet<HashSetProcessor<HashSetIteratorSimple> > HashSetSimple;
 typedef HashSet<HashSetProcessor<HashSetIteratorPair> > HashSetPair;
+typedef HashSet<HashSetProcessor<HashSetIteratorBlocked> > HashSetBlocked;
+/// HashSetPair for filters of M bits and K hashes, fixed at compile time
+template <unsigned int M, unsigned int K>
+using HashSetPairFixed = HashSet<HashSetProcessorPairFixed<M, K> >;
 }
 
 #endif
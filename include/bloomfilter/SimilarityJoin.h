@@ -0,0 +1,94 @@
+//===-- bloomfilter/SimilarityJoin.h - All pairs Dice join ------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains dice_join, which finds the pairs of filters from
+/// two sets that are similar under the Dice coefficient, and a binary format
+/// for its results.
+///
+//===----------------------------------------------------------------------===//
+#ifndef BLOOMFILTER_SIMILARITYJOIN_H_INCLUDED
+#define BLOOMFILTER_SIMILARITYJOIN_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "bloomfilter/FilterArray.h"
+#include "concurrent/ThreadPool.h"
+
+namespace bloomfilter {
+/// Filter left of the left set is similar to filter right of the right set,
+/// with Dice coefficient numerator / denominator
+struct JoinPair {
+  std::uint32_t left;
+  std::uint32_t right;
+  std::uint32_t numerator;
+  std::uint32_t denominator;
+
+  double dice() const {
+    return static_cast<double>(numerator) / static_cast<double>(denominator);
+  }
+};
+
+bool operator==(const JoinPair &lhs, const JoinPair &rhs);
+
+struct JoinOptions {
+  /// Smallest Dice coefficient reported
+  double threshold = 0.8;
+  /// When non-zero, only the best top_k pairs of each left filter are
+  /// reported
+  std::size_t top_k = 0;
+  /// Filters per block. A block from each side should fit in cache together
+  std::size_t block_rows = 256;
+};
+
+/// Receives the pairs of one block of left filters at a time
+typedef std::function<void(const std::vector<JoinPair> &)> JoinEmitter;
+
+/// Finds the pairs of left and right filters with a Dice coefficient of at
+/// least options.threshold, passing them to emit in order of left filter.
+/// For each left filter they are in order of right filter, or from best to
+/// worst when options.top_k is set.
+///
+/// Blocks of left filters are spread over pool, each compared against blocks
+/// of right filters. Right filters are visited in order of bit count, so only
+/// the range whose counts could reach the threshold is compared at all, and
+/// each pair is checked against the bound from its counts before its words.
+void dice_join(const FilterArray &left, const FilterArray &right,
+               const JoinOptions &options, concurrent::ThreadPoolSimple &pool,
+               const JoinEmitter &emit);
+/// As above, but collecting every pair
+std::vector<JoinPair> dice_join(const FilterArray &left,
+                                const FilterArray &right,
+                                const JoinOptions &options,
+                                concurrent::ThreadPoolSimple &pool);
+
+/// Join results are stored as magic "DJN1" followed by each pair as four
+/// uint32 in host byte order, until the end of the stream
+void write_join_header(std::ostream &out);
+void write_join_pairs(std::ostream &out, const std::vector<JoinPair> &pairs);
+/// Reads every pair of a stream written as above. Returns false if it is not
+/// one
+bool read_join(std::istream &in, std::vector<JoinPair> &pairs);
+}
+
+#endif
@@ -24,6 +24,7 @@
 #define COMMON_BITS_H_INCLUDED
 
 #include <cassert>
+#include <type_traits>
 
 namespace common {
 template <typename T>
@@ -39,14 +40,24 @@ template <typename T>
 typename std::enable_if<
     std::is_integral<T>::value && std::is_unsigned<T>::value, T>::type
 popCount(T in) {
-  // TODO, use __builtin_popcount() when available (gcc/clang)
-  // or __popcnt16(), __popcnt(), __popcnt64() (MSVC)
+#if defined(__GNUC__) || defined(__clang__)
+  // The narrowest builtin holding T, which compiles to popcnt where the
+  // target has it
+  if (sizeof(T) <= sizeof(unsigned int))
+    return static_cast<T>(__builtin_popcount(static_cast<unsigned int>(in)));
+  if (sizeof(T) <= sizeof(unsigned long))
+    return static_cast<T>(__builtin_popcountl(static_cast<unsigned long>(in)));
+  return static_cast<T>(
+      __builtin_popcountll(static_cast<unsigned long long>(in)));
+#else
+  // TODO, use __popcnt16(), __popcnt(), __popcnt64() (MSVC)
   T count = 0;
 
   for (; in != 0; ++count)
     in &= static_cast<T>(in - 1);
 
   return count;
+#endif
 }
 
 } // namespace common
@@ -0,0 +1,52 @@
+//===-- graph/Dag.h - Directed acyclic graph helpers -----------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains helpers for graphs without cycles, where every
+/// path is simple and paths can be counted without being enumerated.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GRAPH_DAG_H_INCLUDED
+#define GRAPH_DAG_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include "graph/Graph.h"
+
+namespace graph {
+/// Sets order to the vertices of g in topological order and returns true, or
+/// returns false if g has a cycle
+bool topological_order(const Graph_t &g, std::vector<Vertex_t> &order);
+
+/// Whether g has no cycles
+bool is_acyclic(const Graph_t &g);
+
+/// For each vertex, the number of paths from it to sink in g, where order is
+/// a topological order of g. Parallel edges give distinct paths. Counts
+/// saturate at the largest std::size_t
+std::vector<std::size_t> count_paths_to(const Graph_t &g,
+                                        const std::vector<Vertex_t> &order,
+                                        Vertex_t sink);
+
+/// The number of paths from source to sink if g is acyclic, as above.
+/// Returns 0 if g has a cycle
+std::size_t count_dag_paths(const Graph_t &g, Vertex_t source, Vertex_t sink);
+}
+
+#endif
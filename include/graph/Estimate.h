@@ -0,0 +1,94 @@
+//===-- graph/Estimate.h - Estimating traversal cost ------------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains a random probe estimator of the number of simple
+/// paths in a graph and the size of the search finding them, along with a
+/// policy picking how to search a graph from those estimates.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GRAPH_ESTIMATE_H_INCLUDED
+#define GRAPH_ESTIMATE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "graph/Graph.h"
+
+namespace graph {
+/// Estimated size of the all_simple_paths search from a source to a sink
+struct Estimate {
+  /// Source to sink paths found
+  double paths = 0;
+  /// Vertices discovered other than the sink
+  double nodes = 0;
+};
+
+/// Averages probes random walks from source, each following a random
+/// unvisited out edge at every step and weighting what it sees by the product
+/// of the choices it had (Knuth's estimator). Unbiased, though the spread can
+/// be wide on very uneven graphs. If max_length is not zero, paths longer than
+/// max_length edges are left out as if the search stopped there
+Estimate estimate_simple_paths(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                               std::size_t probes, std::size_t max_length = 0,
+                               std::uint_fast32_t seed = 5489u);
+
+/// Ways of finding the paths of a graph, from most to least complete
+enum class Strategy {
+  // all_simple_paths
+  full,
+  // all_covering_paths, whose pruning shrinks the search
+  covering,
+  // all_simple_paths, leaving out paths longer than Policy::max_length
+  length_bounded,
+  // Nothing is enumerated, only the number of paths is estimated
+  count_only
+};
+
+/// Limits on the estimated search size, in vertices discovered, under which
+/// each strategy is used
+struct Policy {
+  /// Random walks per estimate
+  std::size_t probes = 256;
+  /// Largest search done in full
+  double max_full_nodes = 1e6;
+  /// Largest search done by all_covering_paths when the graph has covers
+  double max_covering_nodes = 1e8;
+  /// Paths kept by length_bounded, in edges. Zero skips that strategy
+  std::size_t max_length = 0;
+  /// Largest search done by length_bounded, as estimated under max_length
+  double max_bounded_nodes = 1e6;
+};
+
+/// A strategy along with the estimate it was picked from
+struct Plan {
+  Strategy strategy = Strategy::count_only;
+  Estimate estimate;
+};
+
+/// Picks the most complete strategy policy allows for the paths from source
+/// to sink. The estimate is the one under max_length for length_bounded, and
+/// the full one otherwise
+Plan plan_traversal(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                    const Policy &policy);
+
+std::ostream &operator<<(std::ostream &out, const Strategy s);
+}
+
+#endif
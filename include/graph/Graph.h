@@ -27,16 +27,26 @@
 #ifndef GRAPH_GRAPH_H_INCLUDED
 #define GRAPH_GRAPH_H_INCLUDED
 
+#include <string>
+
+#include <boost/dynamic_bitset.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
 namespace graph {
 struct vertex_info {
   std::string name;
+  /// Bits this vertex accounts for. Empty if the vertex accounts for nothing
+  boost::dynamic_bitset<> covers;
+};
+struct graph_info {
+  /// Bits a path must account for to be found by all_covering_paths. Empty if
+  /// there is no such requirement
+  boost::dynamic_bitset<> covers;
 };
 typedef boost::adjacency_list<
     boost::vecS, boost::vecS, boost::directedS, vertex_info,
-    boost::property<boost::edge_index_t, std::size_t> > Graph_t;
+    boost::property<boost::edge_index_t, std::size_t>, graph_info> Graph_t;
 typedef boost::graph_traits<Graph_t>::vertex_descriptor Vertex_t;
 typedef boost::graph_traits<Graph_t>::edge_descriptor Edge_t;
 }
@@ -24,10 +24,14 @@
 #ifndef GRAPH_TRAVERSALS_H_INCLUDED
 #define GRAPH_TRAVERSALS_H_INCLUDED
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include "concurrent/ThreadPool.h"
 #include "graph/Graph.h"
 #include "util/Timer.h"
 
@@ -35,7 +39,49 @@ namespace graph {
 enum class Traversal {
   depth_first_search,
   all_simple_paths,
-  all_edge_disjoint_paths
+  all_edge_disjoint_paths,
+  // Simple paths whose vertices together cover all bits in the graph's covers
+  all_covering_paths,
+  // Same paths as all_simple_paths, found by meeting in the middle
+  bidirectional_simple_paths
+};
+
+/// Limits on the work done by a single traversal. A limit of zero means there
+/// is no limit
+struct Budget {
+  /// Paths found
+  std::size_t max_paths = 0;
+  /// Edges examined. Edges are only checked against this and max_time in
+  /// batches, so the traversal may run slightly over
+  std::size_t max_edges = 0;
+  /// Wall time taken
+  std::chrono::steady_clock::duration max_time =
+      std::chrono::steady_clock::duration::zero();
+
+  bool unlimited() const {
+    return max_paths == 0 && max_edges == 0 &&
+           max_time == std::chrono::steady_clock::duration::zero();
+  }
+};
+
+/// What a PathVisitor wants done after seeing a branch or path
+enum class Visit {
+  proceed,
+  // Don't search below this branch. The same as proceed for a path
+  skip,
+  // End the traversal
+  stop
+};
+
+/// Receives the results of a traversal as they are found. Paths are given as
+/// the vertices from source to sink. Either callback may be left empty
+struct PathVisitor {
+  /// Called with the branch each time the search reaches a new vertex other
+  /// than sink. Not called by bidirectional_simple_paths, which has no
+  /// branches
+  std::function<Visit(const std::vector<Vertex_t> &)> extend;
+  /// Called with each path found
+  std::function<Visit(const std::vector<Vertex_t> &)> found;
 };
 
 // Two variations, one taking a timer, the other not
@@ -46,6 +92,55 @@ void run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
                    std::vector<std::vector<std::string> > &paths,
                    Traversal traversal);
 
+// Stops early if budget runs out, leaving the paths found so far. Returns true
+// if stopped early
+bool run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                   std::vector<std::vector<std::string> > &paths,
+                   Traversal traversal, const Budget &budget);
+
+// Passes results to visitor instead of storing them. Returns true if stopped
+// early, either by visitor or by budget
+bool run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                   const PathVisitor &visitor, Traversal traversal,
+                   const Budget &budget = Budget());
+
+// Splits the search below each path split_depth edges long from source into a
+// task for pool, giving the same paths in the same order. The calling thread
+// works on the tasks too, so this may be called from inside one of pool's
+// tasks. Only all_simple_paths is split, others run as above. Returns true if
+// stopped early by budget
+bool run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                   std::vector<std::vector<std::string> > &paths,
+                   Traversal traversal, concurrent::ThreadPoolSimple &pool,
+                   std::size_t split_depth, const Budget &budget = Budget());
+
+/// Scores extending branch, a path from source, by the vertex next. Scores add
+/// up along a path, and higher is more plausible
+typedef std::function<double(const std::vector<Vertex_t> &branch,
+                             Vertex_t next)> ExtensionScore;
+
+/// Receives the paths found by best_first_paths along with their scores
+typedef std::function<Visit(const std::vector<Vertex_t> &path, double score)>
+    ScoredPathVisitor;
+
+// Passes simple paths from source to sink to visitor in order of decreasing
+// total score. The order is exact as long as no score is positive, as with log
+// probabilities. Returns true if stopped early, either by visitor or by budget.
+// Every edge examined keeps a partial path, so only budget.max_edges bounds
+// the memory used
+bool best_first_paths(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                      const ExtensionScore &score,
+                      const ScoredPathVisitor &visitor,
+                      const Budget &budget = Budget());
+
+// As above, storing the first k paths, or all of them if k is zero. The score
+// of each path goes in scores if given
+bool best_first_paths(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                      const ExtensionScore &score, std::size_t k,
+                      std::vector<std::vector<std::string> > &paths,
+                      std::vector<double> *scores = nullptr,
+                      const Budget &budget = Budget());
+
 std::ostream &operator<<(std::ostream &out, const Traversal t);
 }
 
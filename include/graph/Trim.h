@@ -0,0 +1,40 @@
+//===-- graph/Trim.h - Remove vertices off every path ----------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains a pass removing the vertices of a graph that
+/// cannot lie on any path from a source to a sink.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GRAPH_TRIM_H_INCLUDED
+#define GRAPH_TRIM_H_INCLUDED
+
+#include <cstddef>
+
+#include "graph/Graph.h"
+
+namespace graph {
+/// Removes every vertex that is either unreachable from source or cannot reach
+/// sink. The remaining vertices and edges keep their relative order, so source
+/// and sink keep their descriptors when they come before every removed vertex
+/// (as with the graphs from bfeattacks::constructGraph). Edge indices are
+/// renumbered from 0. Returns the number of vertices removed
+std::size_t trim(Graph_t &g, Vertex_t source, Vertex_t sink);
+}
+
+#endif
@@ -0,0 +1,89 @@
+//===-- stats/NGramModel.h - Character n-gram language model ----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains a character n-gram language model, used to rank
+/// candidate words by how plausible they are.
+///
+//===----------------------------------------------------------------------===//
+#ifndef STATS_NGRAMMODEL_H_INCLUDED
+#define STATS_NGRAMMODEL_H_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stats {
+/// Predicts each character of a word from the order - 1 before it, with
+/// additive smoothing. Words are padded with a start sentinel before and an
+/// end sentinel after, like the n-grams inserted into Bloom filters.
+/// Characters outside the alphabet are treated as a sentinel in a context and
+/// as unseen when predicted
+class NGramModel {
+public:
+  /// An empty model, only good for read
+  NGramModel();
+  NGramModel(std::size_t order, const std::string &alphabet,
+             double smoothing = 1);
+
+  /// Counts the n-grams of word
+  void add(const std::string &word);
+
+  /// Natural log of the probability of next following history, the start of
+  /// a word
+  double log_probability(const std::string &history, char next) const;
+  /// Natural log of the probability of the word ending after history
+  double log_probability_end(const std::string &history) const;
+  /// Natural log of the probability of the whole word
+  double log_probability(const std::string &word) const;
+
+  std::size_t order() const { return n; }
+  const std::string &alphabet() const { return symbols; }
+
+  /// Binary format, in host byte order: the magic "NGM1", order and alphabet
+  /// length as uint32, the alphabet, smoothing as a double, then the count of
+  /// every n-gram as uint32 in order of their index
+  void write(std::ostream &out) const;
+  /// Replaces this model by one written by write. Returns false, leaving this
+  /// model empty, if in does not hold one or it would count more than 2^28
+  /// n-grams
+  bool read(std::istream &in);
+
+private:
+  std::size_t n;
+  std::string symbols;
+  double alpha;
+  // Index of each character in symbols plus one, leaving 0 for the sentinels
+  std::array<std::uint32_t, 256> index;
+  // Counts of each n-gram, indexed by its context then the predicted symbol
+  std::vector<std::uint32_t> counts;
+  // Counts of each context, the sum of its row in counts
+  std::vector<std::uint64_t> totals;
+
+  void build_index();
+  std::size_t symbol(char c) const;
+  std::size_t context(const std::string &history) const;
+  double log_probability(std::size_t ctx, std::size_t next) const;
+};
+}
+
+#endif
@@ -0,0 +1,64 @@
+//===-- util/BitKernels.h - Word level bit counting kernels -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains population counts over arrays of 64-bit words,
+/// with the implementation picked at run time from what the processor
+/// supports.
+///
+//===----------------------------------------------------------------------===//
+#ifndef UTIL_BITKERNELS_H_INCLUDED
+#define UTIL_BITKERNELS_H_INCLUDED
+
+// Determine whether x86 specific kernels can be built
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define X86_BIT_KERNELS
+#endif
+// Otherwise only the generic kernel is available
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace util {
+typedef std::uint64_t Word;
+
+/// The implementations of the kernels, from slowest to fastest
+enum class BitKernel { generic, popcnt, avx2, avx512 };
+
+std::ostream &operator<<(std::ostream &out, const BitKernel kernel);
+
+/// Whether the processor can run kernel
+bool bit_kernel_supported(const BitKernel kernel);
+/// The kernel currently used, by default the fastest one supported
+BitKernel bit_kernel();
+/// Uses kernel from now on, returning false (and changing nothing) if it is
+/// not supported. This is for testing and benchmarking, and must not race
+/// with the counts below
+bool force_bit_kernel(const BitKernel kernel);
+
+/// Number of bits set in a[0, n)
+std::size_t count(const Word *a, std::size_t n);
+/// Number of bits set in both a[0, n) and b[0, n)
+std::size_t count_and(const Word *a, const Word *b, std::size_t n);
+/// Number of bits set in either a[0, n) or b[0, n)
+std::size_t count_or(const Word *a, const Word *b, std::size_t n);
+}
+
+#endif
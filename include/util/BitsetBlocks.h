@@ -0,0 +1,125 @@
+//===-- util/BitsetBlocks.h - Word access to dynamic_bitset -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file gives read only access to the words of a
+/// boost::dynamic_bitset, without copying them on the Boost versions whose
+/// layout is known, so the kernels in BitKernels.h can run over it, and
+/// converts other bitsets back to one.
+///
+//===----------------------------------------------------------------------===//
+#ifndef UTIL_BITSETBLOCKS_H_INCLUDED
+#define UTIL_BITSETBLOCKS_H_INCLUDED
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/version.hpp>
+
+#include "util/BitKernels.h"
+
+// Reading the words in place relies on dynamic_bitset keeping them in a
+// std::vector named m_bits and befriending to_block_range, as it does up to
+// Boost 1.86. Later versions, or defining UTIL_BITSETBLOCKS_COPY, copy the
+// words out with to_block_range instead
+#if !defined(UTIL_BITSETBLOCKS_COPY) && BOOST_VERSION < 108700
+#define UTIL_BITSETBLOCKS_IN_PLACE 1
+#endif
+
+namespace util {
+static_assert(std::is_same<boost::dynamic_bitset<>::block_type, Word>::value,
+              "dynamic_bitset blocks must be 64-bit words");
+
+/// The words of a bitset. Bits past its size are always zero
+struct BitsetBlocks {
+  const Word *data;
+  std::size_t size;
+  /// Holds the words when they had to be copied out, shared by copies
+  std::shared_ptr<const std::vector<Word> > copy = nullptr;
+};
+
+/// Valid until bits is resized or destroyed
+BitsetBlocks blocks(const boost::dynamic_bitset<> &bits);
+
+/// bits as a boost::dynamic_bitset, for code that needs one whatever bitset
+/// a filter stores. A dynamic_bitset is passed through without a copy, and
+/// the template copies the words of any bitset blocks() accepts. Bitsets with
+/// no words to give overload it in their own namespace, so call it unqualified
+/// after using util::as_dynamic_bitset
+inline const boost::dynamic_bitset<> &
+as_dynamic_bitset(const boost::dynamic_bitset<> &bits) {
+  return bits;
+}
+template <typename Bits>
+boost::dynamic_bitset<> as_dynamic_bitset(const Bits &bits);
+
+#ifdef UTIL_BITSETBLOCKS_IN_PLACE
+namespace detail {
+struct BitsetBlocksSink {
+  BitsetBlocks *out;
+};
+}
+#endif
+}
+
+#ifdef UTIL_BITSETBLOCKS_IN_PLACE
+namespace boost {
+// dynamic_bitset offers no access to its words besides copying them with
+// to_block_range, which it befriends. Specializing it for our own sink keeps
+// that access while recording where the words are instead
+template <>
+inline void to_block_range(const dynamic_bitset<> &b,
+                           util::detail::BitsetBlocksSink sink) {
+  static_assert(
+      std::is_same<decltype(b.m_bits), std::vector<util::Word> >::value,
+      "dynamic_bitset must keep its words in a std::vector");
+  sink.out->data = b.m_bits.data();
+  sink.out->size = b.m_bits.size();
+}
+}
+
+inline util::BitsetBlocks util::blocks(const boost::dynamic_bitset<> &bits) {
+  BitsetBlocks result{ nullptr, 0 };
+  boost::to_block_range(bits, detail::BitsetBlocksSink{ &result });
+  return result;
+}
+#else
+inline util::BitsetBlocks util::blocks(const boost::dynamic_bitset<> &bits) {
+  auto words = std::make_shared<std::vector<Word> >();
+  words->reserve(bits.num_blocks());
+  boost::to_block_range(bits, std::back_inserter(*words));
+  return BitsetBlocks{ words->data(), words->size(), words };
+}
+#endif
+
+template <typename Bits>
+boost::dynamic_bitset<> util::as_dynamic_bitset(const Bits &bits) {
+  // Found by argument dependent lookup for the other bitsets
+  using util::blocks;
+  const BitsetBlocks words = blocks(bits);
+  boost::dynamic_bitset<> result(words.data,
+                                 words.data + (bits.size() + 63) / 64);
+  result.resize(bits.size());
+  return result;
+}
+
+#endif
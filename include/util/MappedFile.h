@@ -0,0 +1,60 @@
+//===-- util/MappedFile.h - Read only file mapping --------------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file contains a read only mapping of a whole file into memory,
+/// with the mapping system picked by some preprocessor work.
+///
+//===----------------------------------------------------------------------===//
+#ifndef UTIL_MAPPEDFILE_H_INCLUDED
+#define UTIL_MAPPEDFILE_H_INCLUDED
+
+// Determine how mapping should occur
+#if defined(__APPLE__) || defined(__linux__) || defined(__unix__)
+#define POSIX_MAPPING
+#endif
+// Otherwise the whole file is read into memory instead
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace util {
+class MappedFile {
+public:
+  /// Maps filename. Check is_open to see if it worked
+  explicit MappedFile(const std::string &filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool is_open() const { return contents != nullptr; }
+  /// Start of the file, page aligned when mapped
+  const void *data() const { return contents; }
+  std::size_t size() const { return length; }
+
+private:
+  const void *contents;
+  std::size_t length;
+  // Holds the file when it cannot be mapped
+  std::vector<char> fallback;
+};
+}
+
+#endif
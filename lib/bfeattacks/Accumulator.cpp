@@ -28,6 +28,7 @@ using std::endl;
 using std::string;
 
 #include "concurrent/Accumulator.h"
+#include "graph/Estimate.h"
 #include "stats/Confidence.h"
 using stats::confidence_bound;
 
@@ -42,18 +43,54 @@ Accumulator& Accumulator::operator+=(const Accumulator &other) {
   graph_vertices_all += other.graph_vertices_all;
   graph_vertices_real += other.graph_vertices_real;
   graph_vertices_false += other.graph_vertices_false;
+  graph_vertices_trimmed += other.graph_vertices_trimmed;
 
   graph_edges += other.graph_edges;
+  graph_acyclic += other.graph_acyclic;
+  graph_dag_paths += other.graph_dag_paths;
 
   trials += other.trials;
 
+  for (const auto &s : other.adaptive_strategy)
+    adaptive_strategy[s.first] += s.second;
+  adaptive_estimated_nodes += other.adaptive_estimated_nodes;
+  adaptive_actual_nodes += other.adaptive_actual_nodes;
+  adaptive_node_ratio += other.adaptive_node_ratio;
+  adaptive_estimated_paths += other.adaptive_estimated_paths;
+  adaptive_actual_paths += other.adaptive_actual_paths;
+  adaptive_found += other.adaptive_found;
+  adaptive_truncated += other.adaptive_truncated;
+
+  ranked_rank += other.ranked_rank;
+  ranked_found += other.ranked_found;
+  ranked_truncated += other.ranked_truncated;
+
+  prunedStat.total_guess_set += other.prunedStat.total_guess_set;
+  prunedStat.correct_guess_set += other.prunedStat.correct_guess_set;
+  prunedStat.incorrect_guess_set += other.prunedStat.incorrect_guess_set;
+  prunedStat.truncated_guess_set += other.prunedStat.truncated_guess_set;
+  for (const auto &w : other.prunedStat.missed)
+    prunedStat.missed.push_back(w);
+  for (const auto &w : other.prunedStat.truncated)
+    prunedStat.truncated.push_back(w);
+
+  dictionaryStat.total_guess_set += other.dictionaryStat.total_guess_set;
+  dictionaryStat.correct_guess_set += other.dictionaryStat.correct_guess_set;
+  dictionaryStat.incorrect_guess_set +=
+      other.dictionaryStat.incorrect_guess_set;
+  for (const auto &w : other.dictionaryStat.missed)
+    dictionaryStat.missed.push_back(w);
+
   for (std::vector<graph::Traversal>::size_type i = 0, e = traversals.size(); i < e; ++i) {
     traversalStats[i].total_guess_set += other.traversalStats[i].total_guess_set;
     traversalStats[i].correct_guess_set += other.traversalStats[i].correct_guess_set;
     traversalStats[i].incorrect_guess_set += other.traversalStats[i].incorrect_guess_set;
+    traversalStats[i].truncated_guess_set += other.traversalStats[i].truncated_guess_set;
 
     for (const auto &w : other.traversalStats[i].missed)
       traversalStats[i].missed.push_back(w);
+    for (const auto &w : other.traversalStats[i].truncated)
+      traversalStats[i].truncated.push_back(w);
   }
 
   return *this;
@@ -62,8 +99,13 @@ Accumulator& Accumulator::operator+=(const Accumulator &other) {
 namespace {
 template <typename T>
 void printAccumulator(std::ostream &out, const concurrent::Accumulator<T> acc, const std::string name) {
-  out << name << ":\n"
-      << "Range [" << acc.getMin() << ", " << acc.getMax() << "]\n"
+  out << name << ":\n";
+  // getMin and getMax are meaningless with nothing accumulated
+  if (acc.count() == 0) {
+    out << "Empty\n";
+    return;
+  }
+  out << "Range [" << acc.getMin() << ", " << acc.getMax() << "]\n"
     // mean w/ conf bound
     // std dev
       << "density:\n";
@@ -93,7 +135,74 @@ std::ostream &operator<<(std::ostream &out, const bfeattacks::Accumulator &a) {
   printAccumulator(out, a.graph_vertices_all, "graph_vertices_all");
   printAccumulator(out, a.graph_vertices_real, "graph_vertices_real");
   printAccumulator(out, a.graph_vertices_false, "graph_vertices_false");
+  printAccumulator(out, a.graph_vertices_trimmed, "graph_vertices_trimmed");
   printAccumulator(out, a.graph_edges, "graph_edges");
+  printAccumulator(out, a.graph_acyclic, "graph_acyclic");
+  printAccumulator(out, a.graph_dag_paths, "graph_dag_paths");
+
+  if (!a.adaptive_strategy.empty()) {
+    out << "----------------------------------\n"
+        << "Adaptive:\n"
+        << "----------------------------------\n"
+        << "strategy:\n";
+    for (const auto &s : a.adaptive_strategy)
+      out << s.first << ": " << s.second << "\n";
+    printAccumulator(out, a.adaptive_estimated_nodes, "estimated nodes");
+    printAccumulator(out, a.adaptive_actual_nodes, "actual nodes");
+    printAccumulator(out, a.adaptive_node_ratio, "actual / estimated nodes");
+    printAccumulator(out, a.adaptive_estimated_paths, "estimated paths");
+    printAccumulator(out, a.adaptive_actual_paths, "actual paths");
+    printAccumulator(out, a.adaptive_found, "found");
+    printAccumulator(out, a.adaptive_truncated, "truncated");
+  }
+
+  if (a.ranked_found.count() != 0) {
+    out << "----------------------------------\n"
+        << "Ranked by n-gram model:\n"
+        << "----------------------------------\n";
+    printAccumulator(out, a.ranked_rank, "rank of correct guess");
+    printAccumulator(out, a.ranked_found, "found");
+    printAccumulator(out, a.ranked_truncated, "truncated");
+  }
+
+  if (a.prunedStat.total_guess_set.count() != 0 ||
+      a.prunedStat.truncated_guess_set.count() != 0) {
+    out << "----------------------------------\n"
+        << "Dictionary pruned search:\n"
+        << "----------------------------------\n";
+    printAccumulator(out, a.prunedStat.total_guess_set, "total guess set");
+    printAccumulator(out, a.prunedStat.correct_guess_set, "correct guess set");
+    printAccumulator(out, a.prunedStat.incorrect_guess_set,
+                     "incorrect guess set");
+    printAccumulator(out, a.prunedStat.truncated_guess_set,
+                     "truncated guess set");
+
+    out << "Missed by Dictionary pruned search\n";
+    for (const auto &w : a.prunedStat.missed)
+      out << w << " ";
+    out << "\n";
+
+    out << "Truncated by Dictionary pruned search\n";
+    for (const auto &w : a.prunedStat.truncated)
+      out << w << " ";
+    out << "\n";
+  }
+
+  if (a.dictionaryStat.total_guess_set.count() != 0) {
+    out << "----------------------------------\n"
+        << "Dictionary lookup:\n"
+        << "----------------------------------\n";
+    printAccumulator(out, a.dictionaryStat.total_guess_set, "total guess set");
+    printAccumulator(out, a.dictionaryStat.correct_guess_set,
+                     "correct guess set");
+    printAccumulator(out, a.dictionaryStat.incorrect_guess_set,
+                     "incorrect guess set");
+
+    out << "Missed by Dictionary lookup\n";
+    for (const auto &w : a.dictionaryStat.missed)
+      out << w << " ";
+    out << "\n";
+  }
 
   for (std::vector<graph::Traversal>::size_type i = 0, e = a.traversals.size();
        i < e; ++i) {
@@ -103,10 +212,17 @@ std::ostream &operator<<(std::ostream &out, const bfeattacks::Accumulator &a) {
     printAccumulator(out, a.traversalStats[i].correct_guess_set, "correct guess set");
     printAccumulator(out, a.traversalStats[i].incorrect_guess_set, "incorrect guess set");
 
+    printAccumulator(out, a.traversalStats[i].truncated_guess_set, "truncated guess set");
+
     out << "Missed by " << a.traversals[i] << "\n";
     for (const auto &w : a.traversalStats[i].missed)
       out << w << " ";
     out << "\n";
+
+    out << "Truncated by " << a.traversals[i] << "\n";
+    for (const auto &w : a.traversalStats[i].truncated)
+      out << w << " ";
+    out << "\n";
   }
   return out;
 }
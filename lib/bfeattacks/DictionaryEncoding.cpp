@@ -0,0 +1,119 @@
+//===-- bfeattacks/DictionaryEncoding.cpp - Dictionary attack ---*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the non-template parts of the dictionary attack
+//
+//===----------------------------------------------------------------------===//
+
+#include "bfeattacks/DictionaryEncoding.h"
+
+#include <cassert>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "util/BitsetBlocks.h"
+#include "util/Hexadecimal.h"
+
+std::uint64_t bfeattacks::fingerprint(const boost::dynamic_bitset<> &bits) {
+  return fingerprint(util::blocks(bits), bits.size());
+}
+
+std::uint64_t bfeattacks::fingerprint(const util::BitsetBlocks &words,
+                                      std::size_t m) {
+  assert(words.size >= (m + 63) / 64);
+
+  // Mix each block in with the splitmix64 finalizer, starting from the size
+  // so filters differing only in length differ
+  auto mix = [](std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+  };
+  std::uint64_t h = mix(m);
+  for (std::size_t i = 0, e = (m + 63) / 64; i < e; ++i)
+    h = mix(h ^ static_cast<std::uint64_t>(words.data[i])) +
+        0x9e3779b97f4a7c15ull;
+  return h;
+}
+
+std::string bfeattacks::filter_to_hex(const boost::dynamic_bitset<> &bits) {
+  std::string binary;
+  binary.reserve(bits.size());
+  for (std::size_t i = 0, e = bits.size(); i < e; ++i)
+    binary += bits[i] ? '1' : '0';
+  return util::binaryStringToHexString(binary.begin(), binary.end());
+}
+
+bool bfeattacks::filter_from_hex(const std::string &hex, std::size_t m,
+                                 boost::dynamic_bitset<> &bits) {
+  if (hex.size() != (m + 3) / 4)
+    return false;
+
+  bits.clear();
+  bits.resize(m);
+  for (std::size_t i = 0; i < hex.size(); ++i) {
+    if (!std::isxdigit(static_cast<unsigned char>(hex[i])))
+      return false;
+    const unsigned digit = util::hexToByte(hex[i]);
+    for (std::size_t j = 0; j < 4 && 4 * i + j < m; ++j)
+      bits[4 * i + j] = (digit >> (3 - j)) & 1u;
+  }
+  return true;
+}
+
+std::string bfeattacks::filter_to_hex(const adt::AdaptiveBitset &bits) {
+  static const char digits[] = "0123456789ABCDEF";
+  std::vector<unsigned> nibbles((bits.size() + 3) / 4, 0);
+  bits.for_each_set(
+      [&nibbles](std::size_t p) { nibbles[p / 4] |= 8u >> (p % 4); });
+
+  std::string hex;
+  hex.reserve(nibbles.size());
+  for (const unsigned nibble : nibbles)
+    hex += digits[nibble];
+  return hex;
+}
+
+bool bfeattacks::filter_from_hex(const std::string &hex, std::size_t m,
+                                 adt::AdaptiveBitset &bits) {
+  if (hex.size() != (m + 3) / 4)
+    return false;
+
+  adt::AdaptiveBitset read(m);
+  for (std::size_t i = 0; i < hex.size(); ++i) {
+    if (!std::isxdigit(static_cast<unsigned char>(hex[i])))
+      return false;
+    const unsigned digit = util::hexToByte(hex[i]);
+    if (digit == 0)
+      continue;
+    for (std::size_t j = 0; j < 4 && 4 * i + j < m; ++j)
+      if ((digit >> (3 - j)) & 1u)
+        read.set(4 * i + j);
+  }
+  bits = std::move(read);
+  return true;
+}
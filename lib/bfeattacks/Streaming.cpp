@@ -0,0 +1,81 @@
+//===-- bfeattacks/Streaming.cpp - Streaming candidate stages --*- C++ -*--===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the generic streaming candidate stages
+//
+//===----------------------------------------------------------------------===//
+
+#include "bfeattacks/Streaming.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "adt/CandidateSet.h"
+#include "graph/Traversals.h"
+using graph::Visit;
+
+Visit bfeattacks::pass_extend(const CandidateVisitor &next,
+                              const string &prefix) {
+  return next.extend ? next.extend(prefix) : Visit::proceed;
+}
+
+Visit bfeattacks::pass_found(const CandidateVisitor &next,
+                             const string &candidate) {
+  return next.found ? next.found(candidate) : Visit::proceed;
+}
+
+bfeattacks::CandidateVisitor bfeattacks::collect_stage(vector<string> &out) {
+  CandidateVisitor stage;
+  stage.found = [&out](const string &candidate) {
+    out.push_back(candidate);
+    return Visit::proceed;
+  };
+  return stage;
+}
+
+bfeattacks::CandidateVisitor
+bfeattacks::collect_set_stage(adt::CandidateSet &out) {
+  CandidateVisitor stage;
+  stage.found = [&out](const string &candidate) {
+    out.insert(candidate);
+    return Visit::proceed;
+  };
+  return stage;
+}
+
+bfeattacks::CandidateVisitor bfeattacks::limit_stage(std::size_t n,
+                                                     CandidateVisitor next) {
+  // The stage is copied around as a std::function, so the count is shared
+  auto seen = std::make_shared<std::size_t>(0);
+
+  CandidateVisitor stage;
+  stage.extend = [next, n, seen](const string &prefix) {
+    return *seen < n ? pass_extend(next, prefix) : Visit::stop;
+  };
+  stage.found = [next, n, seen](const string &candidate) {
+    if (*seen >= n)
+      return Visit::stop;
+    Visit result = pass_found(next, candidate);
+    return ++*seen < n ? result : Visit::stop;
+  };
+  return stage;
+}
@@ -0,0 +1,227 @@
+//===-- bloomfilter/BitSamplingIndex.cpp - LSH over filters -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a bit sampling locality sensitive hashing index
+//
+//===----------------------------------------------------------------------===//
+
+#include "bloomfilter/BitSamplingIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bloomfilter/FilterArray.h"
+#include "concurrent/ThreadPool.h"
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace {
+template <typename T> void write_vector(std::ostream &out, const vector<T> &v) {
+  out.write(reinterpret_cast<const char *>(v.data()),
+            static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+// Reads count elements into v a block at a time, so a header claiming more
+// than in holds doesn't allocate it all up front
+template <typename T>
+bool read_vector(std::istream &in, vector<T> &v, size_t count) {
+  const size_t block = 1 << 16;
+  v.clear();
+  while (v.size() < count) {
+    const size_t start = v.size();
+    v.resize(start + std::min(block, count - start));
+    if (!in.read(reinterpret_cast<char *>(v.data() + start),
+                 static_cast<std::streamsize>((v.size() - start) * sizeof(T))))
+      return false;
+  }
+  return true;
+}
+}
+
+bloomfilter::BitSamplingIndex::BitSamplingIndex()
+    : params(), indexed(0), tables() {}
+
+bloomfilter::BitSamplingIndex::BitSamplingIndex(
+    FilterArray filters_, const Parameters &parameters_,
+    concurrent::ThreadPoolSimple &pool)
+    : params(parameters_), indexed(std::move(filters_)),
+      tables(parameters_.tables) {
+  assert(params.bits != 0 && params.bits <= 64);
+  assert(params.bits <= indexed.length());
+
+  // Each table samples distinct positions, drawn up front so the result does
+  // not depend on the order tables are built in
+  std::mt19937_64 rng(params.seed);
+  vector<uint32_t> all(indexed.length());
+  std::iota(all.begin(), all.end(), 0);
+  for (Table &table : tables) {
+    for (unsigned int i = 0; i < params.bits; ++i) {
+      std::uniform_int_distribution<size_t> pick(i, all.size() - 1);
+      std::swap(all[i], all[pick(rng)]);
+    }
+    table.positions.assign(all.begin(), all.begin() + params.bits);
+  }
+
+  vector<std::future<void> > built;
+  for (Table &table : tables)
+    built.push_back(pool.submit([&table, this]() { build(table, indexed); }));
+  for (auto &b : built)
+    b.get();
+}
+
+uint64_t bloomfilter::BitSamplingIndex::key(const Table &table,
+                                            const util::Word *words) {
+  uint64_t result = 0;
+  for (const uint32_t p : table.positions)
+    result = (result << 1) | ((words[p / 64] >> (p % 64)) & 1);
+  return result;
+}
+
+void bloomfilter::BitSamplingIndex::build(Table &table,
+                                          const FilterArray &filters) {
+  vector<std::pair<uint64_t, uint32_t> > entries;
+  entries.reserve(filters.size());
+  for (size_t i = 0; i < filters.size(); ++i)
+    entries.emplace_back(key(table, filters.row(i)), static_cast<uint32_t>(i));
+  std::sort(entries.begin(), entries.end());
+
+  table.keys.clear();
+  table.ids.clear();
+  table.keys.reserve(entries.size());
+  table.ids.reserve(entries.size());
+  for (const auto &entry : entries) {
+    table.keys.push_back(entry.first);
+    table.ids.push_back(entry.second);
+  }
+}
+
+size_t bloomfilter::BitSamplingIndex::query(
+    const boost::dynamic_bitset<> &query, double threshold,
+    vector<FilterArray::Hit> &hits) const {
+  assert(query.size() == indexed.length());
+
+  const util::BitsetBlocks q = util::blocks(query);
+  const size_t q_count = util::count(q.data, q.size);
+
+  vector<uint32_t> candidates;
+  for (const Table &table : tables) {
+    const uint64_t k = key(table, q.data);
+    const auto range = std::equal_range(table.keys.begin(), table.keys.end(), k);
+    const auto first = table.ids.begin() + (range.first - table.keys.begin());
+    const auto last = table.ids.begin() + (range.second - table.keys.begin());
+    candidates.insert(candidates.end(), first, last);
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+
+  for (const uint32_t i : candidates) {
+    const size_t count = indexed.count(i);
+    const size_t denominator = q_count + count;
+    if (denominator == 0 || static_cast<double>(2 * std::min(q_count, count)) <
+                                threshold * static_cast<double>(denominator))
+      continue;
+
+    const size_t numerator = 2 * util::count_and(q.data, indexed.row(i), q.size);
+    if (static_cast<double>(numerator) >=
+        threshold * static_cast<double>(denominator))
+      hits.push_back({ i, numerator, denominator });
+  }
+
+  return candidates.size();
+}
+
+double bloomfilter::BitSamplingIndex::recall(size_t hamming) const {
+  const double agree = 1 - static_cast<double>(hamming) /
+                               static_cast<double>(indexed.length());
+  const double bucket = std::pow(agree, params.bits);
+  return 1 - std::pow(1 - bucket, params.tables);
+}
+
+void bloomfilter::BitSamplingIndex::write(std::ostream &out) const {
+  const uint64_t header[] = { params.bits, params.tables, params.seed,
+                              indexed.size() };
+  out.write("BSI1", 4);
+  out.write(reinterpret_cast<const char *>(header), sizeof(header));
+  for (const Table &table : tables) {
+    write_vector(out, table.positions);
+    write_vector(out, table.keys);
+    write_vector(out, table.ids);
+  }
+  indexed.write(out);
+}
+
+bool bloomfilter::BitSamplingIndex::read(std::istream &in) {
+  *this = BitSamplingIndex();
+
+  char magic[4];
+  uint64_t header[4];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, "BSI1", 4) != 0 ||
+      !in.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+      header[0] == 0 || header[0] > 64 || header[1] > UINT32_MAX ||
+      header[3] > UINT32_MAX)
+    return false;
+
+  BitSamplingIndex result;
+  result.params.bits = static_cast<unsigned int>(header[0]);
+  result.params.tables = static_cast<unsigned int>(header[1]);
+  result.params.seed = header[2];
+  const size_t n = static_cast<size_t>(header[3]);
+
+  // Tables are only allocated as they are read, for the same reason
+  for (unsigned int t = 0; t < result.params.tables; ++t) {
+    result.tables.emplace_back();
+    Table &table = result.tables.back();
+    if (!read_vector(in, table.positions, result.params.bits) ||
+        !read_vector(in, table.keys, n) || !read_vector(in, table.ids, n) ||
+        !std::is_sorted(table.keys.begin(), table.keys.end()))
+      return false;
+    // query indexes the filters by these
+    for (const uint32_t id : table.ids)
+      if (id >= n)
+        return false;
+  }
+
+  if (!result.indexed.read(in) || result.indexed.size() != n)
+    return false;
+  for (const Table &table : result.tables)
+    for (const uint32_t p : table.positions)
+      if (p >= result.indexed.length())
+        return false;
+
+  *this = std::move(result);
+  return true;
+}
@@ -0,0 +1,99 @@
+//===-- bloomfilter/BitSlicedBlock.cpp - Transposed filters -----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains BitSlicedBlock, a block of filters stored transposed
+//
+//===----------------------------------------------------------------------===//
+
+#include "bloomfilter/BitSlicedBlock.h"
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "adt/AdaptiveBitset.h"
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+using std::size_t;
+using std::vector;
+
+bloomfilter::BitSlicedBlock::BitSlicedBlock(unsigned int m_, size_t records)
+    : m(m_), capacity(records), words((records + 63) / 64), count(0),
+      slices(m_ * words, 0) {}
+
+size_t bloomfilter::BitSlicedBlock::add(const boost::dynamic_bitset<> &bits) {
+  assert(bits.size() == m);
+  assert(count < capacity);
+
+  const size_t word = count / 64;
+  const util::Word bit = util::Word(1) << (count % 64);
+  for (size_t p = bits.find_first(); p != boost::dynamic_bitset<>::npos;
+       p = bits.find_next(p))
+    slices[p * words + word] |= bit;
+
+  return count++;
+}
+
+size_t bloomfilter::BitSlicedBlock::add(const util::BitsetBlocks &bits) {
+  assert(bits.size >= (m + 63) / 64);
+  assert(count < capacity);
+
+  const size_t word = count / 64;
+  const util::Word bit = util::Word(1) << (count % 64);
+  for (size_t w = 0, e = (m + 63) / 64; w < e; ++w)
+    for (util::Word set = bits.data[w]; set != 0; set &= set - 1)
+      slices[(w * 64 + static_cast<size_t>(__builtin_ctzll(set))) * words +
+             word] |= bit;
+
+  return count++;
+}
+
+size_t bloomfilter::BitSlicedBlock::add(const adt::AdaptiveBitset &bits) {
+  assert(bits.size() == m);
+  assert(count < capacity);
+
+  const size_t word = count / 64;
+  const util::Word bit = util::Word(1) << (count % 64);
+  bits.for_each_set([this, word, bit](size_t p) {
+    slices[p * words + word] |= bit;
+  });
+
+  return count++;
+}
+
+bool bloomfilter::BitSlicedBlock::all_set(const vector<unsigned int> &positions,
+                                          util::Word *out) const {
+  assert(!positions.empty());
+
+  const util::Word *first = &slices[positions[0] * words];
+  util::Word any = 0;
+  for (size_t w = 0; w < words; ++w)
+    any |= out[w] = first[w];
+
+  for (size_t i = 1; i < positions.size() && any != 0; ++i) {
+    const util::Word *slice = &slices[positions[i] * words];
+    any = 0;
+    for (size_t w = 0; w < words; ++w)
+      any |= out[w] &= slice[w];
+  }
+
+  return any != 0;
+}
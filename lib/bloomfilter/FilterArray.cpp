@@ -0,0 +1,177 @@
+//===-- bloomfilter/FilterArray.cpp - Contiguous filter storage -*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains FilterArray, many filters stored back to back
+//
+//===----------------------------------------------------------------------===//
+
+#include "bloomfilter/FilterArray.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+
+using std::size_t;
+using std::uint64_t;
+using std::vector;
+
+namespace {
+const size_t words_per_line = 64 / sizeof(util::Word);
+}
+
+bloomfilter::FilterArray::FilterArray(unsigned int m_)
+    : m(m_), stride(0), words(), counts() {
+  const size_t needed = (m + 63) / 64;
+  stride = (needed + words_per_line - 1) / words_per_line * words_per_line;
+}
+
+size_t bloomfilter::FilterArray::add(const boost::dynamic_bitset<> &bits) {
+  assert(bits.size() == m);
+  return add(util::blocks(bits));
+}
+
+size_t bloomfilter::FilterArray::add(const util::BitsetBlocks &bits) {
+  // Storage may pad past the words needed for m bits, but only with zeros
+  const size_t needed = (m + 63) / 64;
+  assert(bits.size >= needed);
+
+  const size_t start = words.size();
+  words.resize(start + stride, 0);
+  std::copy(bits.data, bits.data + needed,
+            words.begin() + static_cast<std::ptrdiff_t>(start));
+
+  counts.push_back(util::count(bits.data, needed));
+  return counts.size() - 1;
+}
+
+vector<util::Word>
+bloomfilter::FilterArray::pad(const boost::dynamic_bitset<> &query) const {
+  assert(query.size() == m);
+
+  const util::BitsetBlocks source = util::blocks(query);
+  vector<util::Word> padded(stride, 0);
+  std::copy(source.data, source.data + source.size, padded.begin());
+  return padded;
+}
+
+bloomfilter::FilterArray::Ratio
+bloomfilter::FilterArray::dice(const boost::dynamic_bitset<> &query,
+                               size_t i) const {
+  assert(query.size() == m);
+
+  // The query is unpadded, so only compare its words
+  const util::BitsetBlocks q = util::blocks(query);
+  return Ratio(2 * util::count_and(q.data, row(i), q.size),
+               util::count(q.data, q.size) + counts[i]);
+}
+
+void bloomfilter::FilterArray::dice_all(const boost::dynamic_bitset<> &query,
+                                        vector<Ratio> &out) const {
+  const vector<util::Word> q = pad(query);
+  const size_t q_count = util::count(q.data(), stride);
+
+  out.clear();
+  out.reserve(size());
+  for (size_t i = 0, e = size(); i < e; ++i)
+    out.emplace_back(2 * util::count_and(q.data(), row(i), stride),
+                     q_count + counts[i]);
+}
+
+void bloomfilter::FilterArray::dice_at_least(
+    const boost::dynamic_bitset<> &query, double threshold,
+    vector<Hit> &hits) const {
+  const vector<util::Word> q = pad(query);
+  const size_t q_count = util::count(q.data(), stride);
+
+  for (size_t i = 0, e = size(); i < e; ++i) {
+    const size_t denominator = q_count + counts[i];
+    if (denominator == 0)
+      continue;
+
+    // The intersection is at most the smaller count
+    const size_t bound = 2 * std::min(q_count, counts[i]);
+    if (static_cast<double>(bound) <
+        threshold * static_cast<double>(denominator))
+      continue;
+
+    const size_t numerator = 2 * util::count_and(q.data(), row(i), stride);
+    if (static_cast<double>(numerator) >=
+        threshold * static_cast<double>(denominator))
+      hits.push_back({ i, numerator, denominator });
+  }
+}
+
+void bloomfilter::FilterArray::write(std::ostream &out) const {
+  const uint64_t header[] = { m, size() };
+  out.write("FAR1", 4);
+  out.write(reinterpret_cast<const char *>(header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(words.data()),
+            static_cast<std::streamsize>(words.size() * sizeof(util::Word)));
+}
+
+bool bloomfilter::FilterArray::read(std::istream &in) {
+  words.clear();
+  counts.clear();
+
+  char magic[4];
+  uint64_t header[2];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, "FAR1", 4) != 0 ||
+      !in.read(reinterpret_cast<char *>(header), sizeof(header)))
+    return false;
+
+  if (header[0] > UINT32_MAX)
+    return false;
+
+  // Rows are only allocated as they are read, so a header claiming more
+  // filters than in holds fails without allocating them all
+  FilterArray result(static_cast<unsigned int>(header[0]));
+  const size_t last_bits = result.m % 64;
+  for (uint64_t i = 0; i < header[1]; ++i) {
+    const size_t start = result.words.size();
+    result.words.resize(start + result.stride);
+    util::Word *row = &result.words[start];
+    if (!in.read(reinterpret_cast<char *>(row),
+                 static_cast<std::streamsize>(result.stride *
+                                              sizeof(util::Word))))
+      return false;
+
+    // Comparisons count whole words, so bits past m must be clear
+    const size_t needed = (result.m + 63) / 64;
+    if (last_bits != 0 && (row[needed - 1] >> last_bits) != 0)
+      return false;
+    for (size_t w = needed; w < result.stride; ++w)
+      if (row[w] != 0)
+        return false;
+
+    result.counts.push_back(util::count(row, result.stride));
+  }
+
+  *this = std::move(result);
+  return true;
+}
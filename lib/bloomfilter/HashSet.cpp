@@ -95,3 +95,54 @@ operator++(int) {
 unsigned int bloomfilter::HashSetIteratorPair::operator*() {
   return (h1 + h2 * static_cast<unsigned>(index)) % m;
 }
+
+bool bloomfilter::operator==(const bloomfilter::HashSetIteratorBlocked &lhs,
+                             const bloomfilter::HashSetIteratorBlocked &rhs) {
+  return lhs.index == rhs.index;
+}
+
+bool bloomfilter::operator!=(const bloomfilter::HashSetIteratorBlocked &lhs,
+                             const bloomfilter::HashSetIteratorBlocked &rhs) {
+  return lhs.index != rhs.index;
+}
+
+bloomfilter::HashSetIteratorBlocked &bloomfilter::HashSetIteratorBlocked::
+operator++() {
+  if (index < 0 || static_cast<unsigned>(index) >= k - 1)
+    index = -1;
+  else
+    ++index;
+  return *this;
+}
+
+bloomfilter::HashSetIteratorBlocked &bloomfilter::HashSetIteratorBlocked::
+operator++(int) {
+  if (index < 0 || static_cast<unsigned>(index) >= k - 1)
+    index = -1;
+  else
+    ++index;
+  return *this;
+}
+
+unsigned int bloomfilter::HashSetIteratorBlocked::stride(unsigned int h,
+                                                         unsigned int width) {
+  if (width < 2)
+    return 1;
+
+  // Stepping up from anywhere in [1, width) reaches a coprime stride by
+  // width - 1 at the latest
+  for (unsigned int b = h % (width - 1) + 1;; ++b) {
+    unsigned int x = b, y = width;
+    while (y != 0) {
+      const unsigned int r = x % y;
+      x = y;
+      y = r;
+    }
+    if (x == 1)
+      return b;
+  }
+}
+
+unsigned int bloomfilter::HashSetIteratorBlocked::operator*() {
+  return base + (a + b * static_cast<unsigned>(index)) % width;
+}
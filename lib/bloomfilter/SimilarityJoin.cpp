@@ -0,0 +1,244 @@
+//===-- bloomfilter/SimilarityJoin.cpp - All pairs Dice join ----*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a blocked, parallel all pairs Dice similarity join
+//
+//===----------------------------------------------------------------------===//
+
+#include "bloomfilter/SimilarityJoin.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+#include "bloomfilter/FilterArray.h"
+#include "concurrent/ThreadPool.h"
+#include "util/BitKernels.h"
+
+using std::size_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace {
+using bloomfilter::FilterArray;
+using bloomfilter::JoinOptions;
+using bloomfilter::JoinPair;
+
+// Whether a is a better match than b for the same left filter: a higher
+// coefficient, then the lower right filter
+bool better(const JoinPair &a, const JoinPair &b) {
+  const uint64_t lhs = uint64_t(a.numerator) * b.denominator;
+  const uint64_t rhs = uint64_t(b.numerator) * a.denominator;
+  return lhs != rhs ? lhs > rhs : a.right < b.right;
+}
+
+struct RightOrder {
+  // Right filters by bit count, and those counts
+  vector<size_t> order;
+  vector<size_t> counts;
+};
+
+RightOrder sort_by_count(const FilterArray &right) {
+  RightOrder sorted;
+  sorted.order.resize(right.size());
+  std::iota(sorted.order.begin(), sorted.order.end(), 0);
+  std::stable_sort(sorted.order.begin(), sorted.order.end(),
+                   [&right](size_t a, size_t b) {
+                     return right.count(a) < right.count(b);
+                   });
+  for (const size_t i : sorted.order)
+    sorted.counts.push_back(right.count(i));
+  return sorted;
+}
+
+vector<JoinPair> join_block(const FilterArray &left, const FilterArray &right,
+                            const RightOrder &sorted,
+                            const JoinOptions &options, size_t start,
+                            size_t end) {
+  const double t = options.threshold;
+  const size_t words = left.row_words();
+
+  // Only right counts c with 2 min(a, c) >= t (a + c) for some count a in the
+  // block can pass, that is t a / (2 - t) <= c <= (2 - t) a / t. The range is
+  // widened by one either side to stay clear of rounding, as each pair is
+  // checked exactly below anyway
+  size_t low_count = left.count(start), high_count = left.count(start);
+  for (size_t i = start; i < end; ++i) {
+    low_count = std::min(low_count, left.count(i));
+    high_count = std::max(high_count, left.count(i));
+  }
+  const auto first = std::lower_bound(
+      sorted.counts.begin(), sorted.counts.end(), low_count,
+      [t](size_t c, size_t a) {
+        return (static_cast<double>(c) + 1) * (2 - t) <
+               t * static_cast<double>(a);
+      });
+  const auto last = std::upper_bound(
+      first, sorted.counts.end(), high_count, [t](size_t a, size_t c) {
+        return (2 - t) * static_cast<double>(a) <
+               t * (static_cast<double>(c) - 1);
+      });
+  const size_t right_start =
+      static_cast<size_t>(first - sorted.counts.begin());
+  const size_t right_end = static_cast<size_t>(last - sorted.counts.begin());
+
+  // Pairs found for each left filter. With top_k these are kept as a heap
+  // with the worst on top
+  vector<vector<JoinPair> > found(end - start);
+  const auto worse = [](const JoinPair &a, const JoinPair &b) {
+    return better(a, b);
+  };
+
+  for (size_t tile = right_start; tile < right_end;
+       tile += options.block_rows) {
+    const size_t tile_end = std::min(tile + options.block_rows, right_end);
+
+    for (size_t i = start; i < end; ++i) {
+      vector<JoinPair> &pairs = found[i - start];
+      const size_t a = left.count(i);
+      const util::Word *a_words = left.row(i);
+
+      for (size_t s = tile; s < tile_end; ++s) {
+        const size_t j = sorted.order[s];
+        const size_t b = sorted.counts[s];
+        const size_t denominator = a + b;
+        if (denominator == 0)
+          continue;
+
+        // Once top_k pairs are held, only a better one is of interest
+        const bool full = options.top_k != 0 && pairs.size() == options.top_k;
+        JoinPair bound{ static_cast<uint32_t>(i), static_cast<uint32_t>(j),
+                        static_cast<uint32_t>(2 * std::min(a, b)),
+                        static_cast<uint32_t>(denominator) };
+        if (static_cast<double>(bound.numerator) <
+                t * static_cast<double>(denominator) ||
+            (full && better(pairs.front(), bound)))
+          continue;
+
+        JoinPair pair = bound;
+        pair.numerator = static_cast<uint32_t>(
+            2 * util::count_and(a_words, right.row(j), words));
+        if (static_cast<double>(pair.numerator) <
+            t * static_cast<double>(denominator))
+          continue;
+
+        if (options.top_k == 0) {
+          pairs.push_back(pair);
+        } else if (!full) {
+          pairs.push_back(pair);
+          std::push_heap(pairs.begin(), pairs.end(), worse);
+        } else if (better(pair, pairs.front())) {
+          std::pop_heap(pairs.begin(), pairs.end(), worse);
+          pairs.back() = pair;
+          std::push_heap(pairs.begin(), pairs.end(), worse);
+        }
+      }
+    }
+  }
+
+  vector<JoinPair> result;
+  for (vector<JoinPair> &pairs : found) {
+    if (options.top_k == 0)
+      std::sort(pairs.begin(), pairs.end(),
+                [](const JoinPair &a, const JoinPair &b) {
+                  return a.right < b.right;
+                });
+    else
+      std::sort(pairs.begin(), pairs.end(), better);
+    result.insert(result.end(), pairs.begin(), pairs.end());
+  }
+  return result;
+}
+}
+
+bool bloomfilter::operator==(const JoinPair &lhs, const JoinPair &rhs) {
+  return lhs.left == rhs.left && lhs.right == rhs.right &&
+         lhs.numerator == rhs.numerator && lhs.denominator == rhs.denominator;
+}
+
+void bloomfilter::dice_join(const FilterArray &left, const FilterArray &right,
+                            const JoinOptions &options,
+                            concurrent::ThreadPoolSimple &pool,
+                            const JoinEmitter &emit) {
+  assert(left.length() == right.length());
+  assert(options.threshold >= 0 && options.threshold <= 1);
+  assert(options.block_rows != 0);
+
+  const RightOrder sorted = sort_by_count(right);
+
+  vector<std::future<vector<JoinPair> > > blocks;
+  for (size_t start = 0; start < left.size(); start += options.block_rows) {
+    const size_t end = std::min(start + options.block_rows, left.size());
+    blocks.push_back(pool.submit([&left, &right, &sorted, &options, start,
+                                  end]() {
+      return join_block(left, right, sorted, options, start, end);
+    }));
+  }
+
+  for (auto &block : blocks)
+    emit(block.get());
+}
+
+vector<bloomfilter::JoinPair>
+bloomfilter::dice_join(const FilterArray &left, const FilterArray &right,
+                       const JoinOptions &options,
+                       concurrent::ThreadPoolSimple &pool) {
+  vector<JoinPair> all;
+  dice_join(left, right, options, pool,
+            [&all](const vector<JoinPair> &pairs) {
+              all.insert(all.end(), pairs.begin(), pairs.end());
+            });
+  return all;
+}
+
+void bloomfilter::write_join_header(std::ostream &out) {
+  out.write("DJN1", 4);
+}
+
+void bloomfilter::write_join_pairs(std::ostream &out,
+                                   const vector<JoinPair> &pairs) {
+  for (const JoinPair &pair : pairs) {
+    const uint32_t fields[] = { pair.left, pair.right, pair.numerator,
+                                pair.denominator };
+    out.write(reinterpret_cast<const char *>(fields), sizeof(fields));
+  }
+}
+
+bool bloomfilter::read_join(std::istream &in, vector<JoinPair> &pairs) {
+  pairs.clear();
+
+  char header[4];
+  if (!in.read(header, sizeof(header)) ||
+      std::memcmp(header, "DJN1", 4) != 0)
+    return false;
+
+  uint32_t fields[4];
+  while (in.read(reinterpret_cast<char *>(fields), sizeof(fields)))
+    pairs.push_back({ fields[0], fields[1], fields[2], fields[3] });
+
+  // Anything left over is a partial pair
+  return in.gcount() == 0;
+}
@@ -0,0 +1,94 @@
+//===-- graph/Dag.cpp - Directed acyclic graph helpers ---------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains helpers for directed acyclic graphs
+//
+//===----------------------------------------------------------------------===//
+
+#include "graph/Dag.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+
+#include "graph/Graph.h"
+using graph::Graph_t;
+using graph::Vertex_t;
+
+bool graph::topological_order(const Graph_t &g, std::vector<Vertex_t> &order) {
+  const std::size_t n = num_vertices(g);
+
+  // Kahn's algorithm, repeatedly taking a vertex with no remaining in edges
+  std::vector<std::size_t> in_degree(n, 0);
+  boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+  for (Vertex_t u = 0; u < n; ++u)
+    for (boost::tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei)
+      ++in_degree[target(*ei, g)];
+
+  order.clear();
+  order.reserve(n);
+  for (Vertex_t u = 0; u < n; ++u)
+    if (in_degree[u] == 0)
+      order.push_back(u);
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+    for (boost::tie(ei, ei_end) = out_edges(order[i], g); ei != ei_end; ++ei)
+      if (--in_degree[target(*ei, g)] == 0)
+        order.push_back(target(*ei, g));
+
+  // Vertices on or after a cycle never run out of in edges
+  return order.size() == n;
+}
+
+bool graph::is_acyclic(const Graph_t &g) {
+  std::vector<Vertex_t> order;
+  return topological_order(g, order);
+}
+
+std::vector<std::size_t>
+graph::count_paths_to(const Graph_t &g, const std::vector<Vertex_t> &order,
+                      Vertex_t sink) {
+  const std::size_t saturated = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> count(num_vertices(g), 0);
+
+  // Every vertex comes after those it has edges to when going in reverse
+  for (auto i = order.rbegin(), e = order.rend(); i != e; ++i) {
+    if (*i == sink) {
+      count[*i] = 1;
+      continue;
+    }
+
+    boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = out_edges(*i, g); ei != ei_end; ++ei) {
+      const std::size_t more = count[target(*ei, g)];
+      count[*i] = (saturated - count[*i] < more) ? saturated : count[*i] + more;
+    }
+  }
+
+  return count;
+}
+
+std::size_t graph::count_dag_paths(const Graph_t &g, Vertex_t source,
+                                   Vertex_t sink) {
+  std::vector<Vertex_t> order;
+  if (!topological_order(g, order))
+    return 0;
+  return count_paths_to(g, order, sink)[source];
+}
@@ -0,0 +1,139 @@
+//===-- graph/Estimate.cpp - Estimating traversal cost ----------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the random probe estimator and the policy built on it
+//
+//===----------------------------------------------------------------------===//
+
+#include "graph/Estimate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+
+#include "graph/Graph.h"
+using graph::Graph_t;
+using graph::Vertex_t;
+
+graph::Estimate graph::estimate_simple_paths(const Graph_t &g,
+                                             Vertex_t source, Vertex_t sink,
+                                             std::size_t probes,
+                                             std::size_t max_length,
+                                             std::uint_fast32_t seed) {
+  Estimate total;
+  if (probes == 0)
+    return total;
+
+  std::mt19937 mt(seed);
+  std::vector<bool> visited(num_vertices(g), false);
+  std::vector<Vertex_t> walk;
+  std::vector<Vertex_t> children;
+
+  for (std::size_t probe = 0; probe < probes; ++probe) {
+    // Number of branches of the search tree like the one walked so far
+    double weight = 1;
+    Vertex_t u = source;
+    walk.assign(1, source);
+    visited[source] = true;
+    total.nodes += 1;
+
+    // Searching below a walk of max_length vertices only finds longer paths
+    while (max_length == 0 || walk.size() <= max_length) {
+      std::size_t to_sink = 0;
+      children.clear();
+      boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+      for (boost::tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei) {
+        const Vertex_t v = target(*ei, g);
+        if (v == sink)
+          ++to_sink;
+        else if (!visited[v])
+          children.push_back(v);
+      }
+
+      total.paths += weight * static_cast<double>(to_sink);
+      total.nodes += weight * static_cast<double>(children.size());
+      if (children.empty())
+        break;
+
+      std::uniform_int_distribution<std::size_t> pick(0, children.size() - 1);
+      weight *= static_cast<double>(children.size());
+      u = children[pick(mt)];
+      walk.push_back(u);
+      visited[u] = true;
+    }
+
+    for (const auto v : walk)
+      visited[v] = false;
+  }
+
+  total.paths /= static_cast<double>(probes);
+  total.nodes /= static_cast<double>(probes);
+  return total;
+}
+
+graph::Plan graph::plan_traversal(const Graph_t &g, Vertex_t source,
+                                  Vertex_t sink, const Policy &policy) {
+  Plan plan;
+  plan.estimate = estimate_simple_paths(g, source, sink, policy.probes);
+
+  if (plan.estimate.nodes <= policy.max_full_nodes) {
+    plan.strategy = Strategy::full;
+    return plan;
+  }
+
+  if (g[boost::graph_bundle].covers.any() &&
+      plan.estimate.nodes <= policy.max_covering_nodes) {
+    plan.strategy = Strategy::covering;
+    return plan;
+  }
+
+  if (policy.max_length != 0) {
+    const Estimate bounded = estimate_simple_paths(
+        g, source, sink, policy.probes, policy.max_length);
+    if (bounded.nodes <= policy.max_bounded_nodes) {
+      plan.strategy = Strategy::length_bounded;
+      plan.estimate = bounded;
+      return plan;
+    }
+  }
+
+  plan.strategy = Strategy::count_only;
+  return plan;
+}
+
+std::ostream &graph::operator<<(std::ostream &out, const Strategy s) {
+  switch (s) {
+  case Strategy::full:
+    out << "Full";
+    break;
+  case Strategy::covering:
+    out << "Covering";
+    break;
+  case Strategy::length_bounded:
+    out << "Length bounded";
+    break;
+  case Strategy::count_only:
+    out << "Count only";
+    break;
+  }
+  return out;
+}
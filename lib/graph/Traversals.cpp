@@ -25,29 +25,119 @@
 
 #include "graph/Traversals.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/depth_first_search.hpp>
+#include <boost/property_map/property_map.hpp>
 #include <boost/graph/visitors.hpp>
 
+#include "concurrent/ThreadPool.h"
+#include "graph/Dag.h"
 #include "graph/Graph.h"
 using graph::Graph_t;
 using graph::Edge_t;
 using graph::Vertex_t;
 
 namespace {
+// Thrown to unwind a traversal once its budget is spent
+struct budget_exhausted {};
+
+// Usage of a Budget, shared by every task working on one traversal
+struct budget_state {
+  explicit budget_state(const graph::Budget &budget_)
+      : budget(budget_),
+        deadline(std::chrono::steady_clock::now() + budget.max_time),
+        edges(0), paths(0), exhausted(false) {}
+
+  const graph::Budget budget;
+  const std::chrono::steady_clock::time_point deadline;
+  std::atomic<std::size_t> edges;
+  std::atomic<std::size_t> paths;
+  std::atomic<bool> exhausted;
+};
+
+// Charges the work of one thread to a budget_state, throwing budget_exhausted
+// when it runs out. Edges are batched up before being charged so the clock
+// and shared counters are only touched every interval edges
+class budget_meter {
+public:
+  explicit budget_meter(budget_state *state_ = nullptr)
+      : state(state_), pending(0), interval(1024) {
+    if (state && state->budget.max_edges != 0 &&
+        state->budget.max_edges < interval)
+      interval = state->budget.max_edges;
+  }
+
+  void edge() {
+    if (state && ++pending >= interval)
+      flush();
+  }
+
+  // Called before recording a path
+  void path() {
+    if (!state)
+      return;
+    const std::size_t max_paths = state->budget.max_paths;
+    if (state->exhausted ||
+        (max_paths != 0 && state->paths.fetch_add(1) >= max_paths))
+      stop();
+  }
+
+  void flush() {
+    if (!state)
+      return;
+    const graph::Budget &budget = state->budget;
+    const std::size_t edges = state->edges += pending;
+    pending = 0;
+    if (state->exhausted ||
+        (budget.max_edges != 0 && edges > budget.max_edges) ||
+        (budget.max_time != std::chrono::steady_clock::duration::zero() &&
+         std::chrono::steady_clock::now() > state->deadline))
+      stop();
+  }
+
+private:
+  budget_state *state;
+  std::size_t pending;
+  std::size_t interval;
+
+  void stop() {
+    state->exhausted = true;
+    throw budget_exhausted();
+  }
+};
+
 class targeted_path_visitor : public boost::default_dfs_visitor {
 public:
   targeted_path_visitor(const Vertex_t stop_,
-                        std::vector<std::vector<std::string> > &paths)
-      : branch(), found_paths(paths), stop(stop_) {}
+                        std::vector<std::vector<std::string> > &paths,
+                        const std::vector<std::string> &prefix = {},
+                        budget_meter *meter_ = nullptr)
+      : branch(prefix), found_paths(paths), stop(stop_), meter(meter_) {}
 
   // void back_edge(Edge e, const Graph& g) const {}
   void examine_edge(Edge_t e, const Graph_t &g) {
+    if (meter)
+      meter->edge();
     // cout << "examine_edge: (" << g[source(e,g)].name << ", " << g[target(e,
     // g)].name << ")\n";
     if (target(e, g) != stop)
       return;
 
+    if (meter)
+      meter->path();
     branch.push_back(g[stop].name);
 
     // cout << "--- path: ";
@@ -85,13 +175,91 @@ private:
   std::vector<std::string> branch;
   std::vector<std::vector<std::string> > &found_paths;
   const Vertex_t stop;
+  budget_meter *meter;
 };
 
-template <class VertexListGraph, class DFSVisitor>
+// Thrown to unwind a traversal when a graph::PathVisitor asks to stop
+struct traversal_stopped {};
+
+// Passes branches and paths to a graph::PathVisitor as they are found. When
+// the visitor asks to skip a branch, skip is set for skip_requested to see
+class streaming_path_visitor : public boost::default_dfs_visitor {
+public:
+  streaming_path_visitor(const Vertex_t stop_,
+                         const graph::PathVisitor &visitor_, bool *skip_,
+                         budget_meter *meter_)
+      : branch(), visitor(visitor_), skip(skip_), stop(stop_), meter(meter_) {}
+
+  void examine_edge(Edge_t e, const Graph_t &g) {
+    if (meter)
+      meter->edge();
+    if (target(e, g) != stop)
+      return;
+
+    if (meter)
+      meter->path();
+    if (!visitor.found)
+      return;
+
+    branch.push_back(stop);
+    graph::Visit next = visitor.found(branch);
+    branch.pop_back();
+    if (next == graph::Visit::stop)
+      throw traversal_stopped();
+  }
+
+  void discover_vertex(Vertex_t v, const Graph_t & /*g*/) {
+    branch.push_back(v);
+    if (v == stop || !visitor.extend)
+      return;
+
+    switch (visitor.extend(branch)) {
+    case graph::Visit::proceed:
+      break;
+    case graph::Visit::skip:
+      *skip = true;
+      break;
+    case graph::Visit::stop:
+      throw traversal_stopped();
+    }
+  }
+
+  void finish_vertex(Vertex_t /*v*/, const Graph_t & /*g*/) {
+    branch.pop_back();
+  }
+
+private:
+  std::vector<Vertex_t> branch;
+  const graph::PathVisitor &visitor;
+  bool *skip;
+  const Vertex_t stop;
+  budget_meter *meter;
+};
+
+// Terminator function for the searches below. Stops the search from going
+// past the vertex just discovered if a skip was requested there
+class skip_requested {
+public:
+  explicit skip_requested(bool *skip_) : skip(skip_) {}
+
+  bool operator()(Vertex_t /*v*/, const Graph_t & /*g*/) const {
+    if (!*skip)
+      return false;
+    *skip = false;
+    return true;
+  }
+
+private:
+  bool *skip;
+};
+
+template <class VertexListGraph, class DFSVisitor,
+          class TerminatorFunc = boost::detail::nontruth2>
 void
 all_edge_disjoint_paths(const VertexListGraph &g, DFSVisitor vis,
                         typename boost::graph_traits<
-                            VertexListGraph>::vertex_descriptor start_vertex) {
+                            VertexListGraph>::vertex_descriptor start_vertex,
+                        TerminatorFunc func = TerminatorFunc()) {
   typedef typename boost::graph_traits<VertexListGraph>::vertex_descriptor
   Vertex;
   typedef typename boost::graph_traits<VertexListGraph>::edge_descriptor Edge;
@@ -120,8 +288,10 @@ all_edge_disjoint_paths(const VertexListGraph &g, DFSVisitor vis,
   Vertex current = start_vertex;
 
   boost::tie(ei, ei_end) = out_edges(current, g);
-  stack.push_back(std::make_pair(current, std::make_pair(ei, ei_end)));
   vis.discover_vertex(current, g);
+  if (func(current, g))
+    ei = ei_end;
+  stack.push_back(std::make_pair(current, std::make_pair(ei, ei_end)));
 
   while (!stack.empty()) {
     VertexInfo &back = stack.back();
@@ -141,6 +311,8 @@ all_edge_disjoint_paths(const VertexListGraph &g, DFSVisitor vis,
         current = next;
         vis.discover_vertex(current, g);
         boost::tie(ei, ei_end) = out_edges(current, g);
+        if (func(current, g))
+          ei = ei_end;
       } else {
         // Already seen this edge
         ++ei;
@@ -276,6 +448,71 @@ void all_simple_paths(const VertexListGraph &g, DFSVisitor vis,
   all_simple_paths(g, boost::visitor(vis).root_vertex(start_vertex));
 }
 
+// all_simple_paths for an acyclic graph. Every path is then simple, so no
+// colors are needed, and vertices with no path to the sink (to_sink[v] == 0)
+// are never entered. Paths are found in the same order as all_simple_paths
+template <class DFSVisitor, class TerminatorFunc = boost::detail::nontruth2>
+void dag_all_paths(const Graph_t &g, DFSVisitor &vis, Vertex_t u,
+                   const std::vector<std::size_t> &to_sink,
+                   TerminatorFunc func = TerminatorFunc()) {
+  typedef boost::graph_traits<Graph_t>::out_edge_iterator Iter;
+  typedef std::pair<Vertex_t, std::pair<Iter, Iter> > VertexInfo;
+
+  Iter ei, ei_end;
+  std::vector<VertexInfo> stack;
+
+  vis.discover_vertex(u, g);
+  boost::tie(ei, ei_end) = out_edges(u, g);
+  if (func(u, g))
+    ei = ei_end;
+  stack.push_back(std::make_pair(u, std::make_pair(ei, ei_end)));
+
+  while (!stack.empty()) {
+    u = stack.back().first;
+    boost::tie(ei, ei_end) = stack.back().second;
+    stack.pop_back();
+    while (ei != ei_end) {
+      Vertex_t v = target(*ei, g);
+      vis.examine_edge(*ei, g);
+      if (to_sink[v] == 0) {
+        ++ei;
+        continue;
+      }
+      stack.push_back(std::make_pair(u, std::make_pair(++ei, ei_end)));
+      u = v;
+      vis.discover_vertex(u, g);
+      boost::tie(ei, ei_end) = out_edges(u, g);
+      if (func(u, g))
+        ei = ei_end;
+    }
+    vis.finish_vertex(u, g);
+  }
+}
+
+// all_simple_paths from start_vertex, switching to dag_all_paths when g has
+// no cycles
+template <class DFSVisitor, class TerminatorFunc = boost::detail::nontruth2>
+void simple_paths(const Graph_t &g, DFSVisitor &vis, Vertex_t start_vertex,
+                  Vertex_t stop_vertex,
+                  TerminatorFunc func = TerminatorFunc()) {
+  typedef boost::color_traits<boost::default_color_type> Color;
+
+  std::vector<Vertex_t> order;
+  if (graph::topological_order(g, order)) {
+    dag_all_paths(g, vis, start_vertex,
+                  graph::count_paths_to(g, order, stop_vertex), func);
+    return;
+  }
+
+  std::vector<boost::default_color_type> colors(num_vertices(g),
+                                                Color::white());
+  all_simple_paths_impl(
+      g, start_vertex, vis,
+      boost::make_iterator_property_map(colors.begin(),
+                                        get(boost::vertex_index, g)),
+      func);
+}
+
 template <class VertexListGraph, class DFSVisitor, class ColorMap>
 void depth_first_search_reachable(
     const VertexListGraph &g, DFSVisitor vis, ColorMap color,
@@ -327,12 +564,427 @@ void depth_first_search(const VertexListGraph &g, DFSVisitor vis,
   depth_first_search_reachable(g,
                                boost::visitor(vis).root_vertex(start_vertex));
 }
+
+// Enumerates the simple paths from start_vertex to stop_vertex whose vertices
+// together cover every bit in the graph's covers. Each time a branch is
+// extended, the vertices still reachable without revisiting the branch are
+// checked, and the branch is abandoned if they cannot supply the bits still
+// needed or if stop_vertex is no longer reachable.
+//
+// The visitor only has edges into stop_vertex examined once the branch is
+// fully covered, so targeted_path_visitor records just the covering paths
+template <class DFSVisitor, class TerminatorFunc = boost::detail::nontruth2>
+void all_covering_paths(const Graph_t &g, DFSVisitor vis, Vertex_t start_vertex,
+                        Vertex_t stop_vertex,
+                        TerminatorFunc func = TerminatorFunc()) {
+  BOOST_CONCEPT_ASSERT((boost::DFSVisitorConcept<DFSVisitor, Graph_t>));
+  typedef boost::graph_traits<Graph_t>::out_edge_iterator Iter;
+  typedef std::pair<Vertex_t, std::pair<Iter, Iter> > VertexInfo;
+  typedef boost::dynamic_bitset<>::size_type size_type;
+
+  const boost::dynamic_bitset<> &required = g[boost::graph_bundle].covers;
+
+  // Vertices whose covers do not line up with required account for nothing
+  auto covers_something = [&](Vertex_t v) {
+    return g[v].covers.size() == required.size() && !required.empty();
+  };
+
+  // Number of vertices on the branch that account for each bit, and the bits
+  // of required no vertex on the branch accounts for yet
+  std::vector<unsigned> times_covered(required.size(), 0);
+  boost::dynamic_bitset<> needed(required);
+  std::vector<bool> on_branch(num_vertices(g), false);
+
+  auto enter = [&](Vertex_t v) {
+    on_branch[v] = true;
+    if (!covers_something(v))
+      return;
+    const boost::dynamic_bitset<> &c = g[v].covers;
+    for (size_type b = c.find_first(); b != c.npos; b = c.find_next(b))
+      if (times_covered[b]++ == 0)
+        needed.reset(b);
+  };
+  auto leave = [&](Vertex_t v) {
+    on_branch[v] = false;
+    if (!covers_something(v))
+      return;
+    const boost::dynamic_bitset<> &c = g[v].covers;
+    for (size_type b = c.find_first(); b != c.npos; b = c.find_next(b))
+      if (--times_covered[b] == 0 && required.test(b))
+        needed.set(b);
+  };
+
+  // Whether the branch ending at u can still be completed into a covering path
+  std::vector<bool> seen(num_vertices(g), false);
+  std::vector<Vertex_t> pending;
+  auto can_complete = [&](Vertex_t u) {
+    boost::dynamic_bitset<> missing(needed);
+    bool stop_reachable = false;
+
+    std::fill(seen.begin(), seen.end(), false);
+    pending.clear();
+    pending.push_back(u);
+    while (!pending.empty() && !(stop_reachable && missing.none())) {
+      Vertex_t x = pending.back();
+      pending.pop_back();
+
+      Iter ei, ei_end;
+      for (boost::tie(ei, ei_end) = out_edges(x, g); ei != ei_end; ++ei) {
+        Vertex_t y = target(*ei, g);
+        if (y == stop_vertex) {
+          stop_reachable = true;
+          continue;
+        }
+        if (on_branch[y] || seen[y])
+          continue;
+        seen[y] = true;
+        if (covers_something(y))
+          missing -= g[y].covers;
+        pending.push_back(y);
+      }
+    }
+
+    return stop_reachable && missing.none();
+  };
+
+  vis.start_vertex(start_vertex, g);
+
+  Iter ei, ei_end;
+  std::vector<VertexInfo> stack;
+  Vertex_t u = start_vertex;
+
+  enter(u);
+  vis.discover_vertex(u, g);
+  boost::tie(ei, ei_end) = out_edges(u, g);
+  if (func(u, g) || !can_complete(u))
+    ei = ei_end;
+  stack.push_back(std::make_pair(u, std::make_pair(ei, ei_end)));
+
+  while (!stack.empty()) {
+    VertexInfo &back = stack.back();
+    u = back.first;
+    boost::tie(ei, ei_end) = back.second;
+    stack.pop_back();
+    while (ei != ei_end) {
+      Vertex_t v = target(*ei, g);
+      if (v == stop_vertex) {
+        if (needed.none())
+          vis.examine_edge(*ei, g);
+        ++ei;
+        continue;
+      }
+
+      vis.examine_edge(*ei, g);
+      if (on_branch[v]) {
+        ++ei;
+        continue;
+      }
+
+      enter(v);
+      vis.discover_vertex(v, g);
+      // func must always be called so it sees every discovered vertex
+      const bool terminate = func(v, g);
+      if (terminate || !can_complete(v)) {
+        // Dead or unwanted branch, back out of v immediately
+        leave(v);
+        vis.finish_vertex(v, g);
+        ++ei;
+        continue;
+      }
+
+      stack.push_back(std::make_pair(u, std::make_pair(++ei, ei_end)));
+      u = v;
+      boost::tie(ei, ei_end) = out_edges(u, g);
+    }
+    leave(u);
+    vis.finish_vertex(u, g);
+  }
+}
+
+// Simple paths leaving start with at most max_length edges, grouped by the
+// vertex they end at and then by their length. Paths are never extended past
+// stop
+typedef std::vector<std::vector<std::vector<std::vector<Vertex_t> > > >
+HalfPaths;
+
+HalfPaths half_paths(const std::vector<std::vector<Vertex_t> > &adjacency,
+                     Vertex_t start, Vertex_t stop, std::size_t max_length,
+                     budget_meter &meter) {
+  HalfPaths halves(adjacency.size(),
+                   std::vector<std::vector<std::vector<Vertex_t> > >(
+                       max_length + 1));
+  std::vector<bool> on_branch(adjacency.size(), false);
+
+  // branch is the current path, next[i] the next neighbor of branch[i] to try
+  std::vector<Vertex_t> branch{ start };
+  std::vector<std::size_t> next{ 0 };
+  on_branch[start] = true;
+  halves[start][0].push_back(branch);
+
+  while (!branch.empty()) {
+    Vertex_t u = branch.back();
+    if ((u == stop && branch.size() > 1) || branch.size() > max_length ||
+        next.back() == adjacency[u].size()) {
+      on_branch[u] = false;
+      branch.pop_back();
+      next.pop_back();
+      continue;
+    }
+
+    Vertex_t v = adjacency[u][next.back()++];
+    meter.edge();
+    if (on_branch[v])
+      continue;
+
+    on_branch[v] = true;
+    branch.push_back(v);
+    next.push_back(0);
+    halves[v][branch.size() - 1].push_back(branch);
+  }
+
+  return halves;
+}
+
+// Finds all simple paths from start_vertex to stop_vertex by meeting in the
+// middle. Every path with L edges is split at the vertex ceil(L/2) edges from
+// start_vertex, so it is the join of a forward half of ceil(L/2) edges and a
+// backward half (found on the reversed graph) of floor(L/2) edges ending at
+// the same vertex. Neither half is longer than half the number of vertices.
+//
+// Paths are found in a different order than all_simple_paths, and each is
+// passed to emit as a vector of vertices
+template <class EmitFunc>
+void bidirectional_simple_paths(const Graph_t &g, Vertex_t start_vertex,
+                                Vertex_t stop_vertex, budget_meter &meter,
+                                EmitFunc emit) {
+  const std::size_t n = num_vertices(g);
+  if (n < 2 || start_vertex == stop_vertex)
+    return;
+
+  std::vector<std::vector<Vertex_t> > forward(n);
+  std::vector<std::vector<Vertex_t> > backward(n);
+  for (Vertex_t u = 0; u < n; ++u) {
+    boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei) {
+      forward[u].push_back(target(*ei, g));
+      backward[target(*ei, g)].push_back(u);
+    }
+  }
+
+  // A simple path has at most n - 1 edges
+  const std::size_t max_forward = n / 2;
+  const std::size_t max_backward = (n - 1) / 2;
+  const HalfPaths from_start =
+      half_paths(forward, start_vertex, stop_vertex, max_forward, meter);
+  const HalfPaths from_stop =
+      half_paths(backward, stop_vertex, start_vertex, max_backward, meter);
+
+  std::vector<bool> on_path(n, false);
+  std::vector<Vertex_t> path;
+  for (Vertex_t v = 0; v < n; ++v) {
+    for (std::size_t a = 1; a <= max_forward; ++a) {
+      for (const auto &front : from_start[v][a]) {
+        for (const auto i : front)
+          on_path[i] = true;
+
+        for (std::size_t b = a - 1; b <= a && b <= max_backward; ++b) {
+          for (const auto &back : from_stop[v][b]) {
+            // back[b] is v, which is shared
+            bool disjoint = true;
+            for (std::size_t i = 0; i < b && disjoint; ++i)
+              disjoint = !on_path[back[i]];
+            if (!disjoint)
+              continue;
+
+            meter.path();
+            path.assign(front.begin(), front.end());
+            for (std::size_t i = b; i-- > 0;)
+              path.push_back(back[i]);
+            emit(path);
+          }
+        }
+
+        for (const auto i : front)
+          on_path[i] = false;
+      }
+    }
+  }
+}
+
+void bidirectional_simple_paths(const Graph_t &g, Vertex_t start_vertex,
+                                Vertex_t stop_vertex,
+                                std::vector<std::vector<std::string> > &paths,
+                                budget_meter &meter) {
+  bidirectional_simple_paths(
+      g, start_vertex, stop_vertex, meter,
+      [&g, &paths](const std::vector<Vertex_t> &path) {
+        std::vector<std::string> names;
+        names.reserve(path.size());
+        for (const auto v : path)
+          names.push_back(g[v].name);
+        paths.push_back(std::move(names));
+      });
+}
+
+// Finds the simple paths to stop_vertex that begin with prefix, in the same
+// order all_simple_paths would find them
+void all_simple_paths_with_prefix(
+    const Graph_t &g, const std::vector<Vertex_t> &prefix,
+    Vertex_t stop_vertex, std::vector<std::vector<std::string> > &paths,
+    budget_meter &meter) {
+  typedef boost::color_traits<boost::default_color_type> Color;
+
+  std::vector<boost::default_color_type> colors(num_vertices(g),
+                                                Color::white());
+  auto color = boost::make_iterator_property_map(colors.begin(),
+                                                 get(boost::vertex_index, g));
+
+  // The last vertex of the prefix is discovered by the search itself
+  std::vector<std::string> names;
+  for (std::vector<Vertex_t>::size_type i = 0; i + 1 < prefix.size(); ++i) {
+    put(color, prefix[i], Color::gray());
+    names.push_back(g[prefix[i]].name);
+  }
+
+  targeted_path_visitor vis(stop_vertex, paths, names, &meter);
+  all_simple_paths_impl(g, prefix.back(), vis, color,
+                        boost::detail::nontruth2());
+}
+
+// A subtree of all_simple_paths below a fixed prefix. Whichever of the pool
+// and the thread waiting on the result claims it first runs it
+struct subtree_task {
+  std::vector<Vertex_t> prefix;
+  std::atomic<bool> claimed{ false };
+  std::promise<void> done;
+  std::vector<std::vector<std::string> > paths;
+};
+
+void run_subtree(const Graph_t &g, Vertex_t stop_vertex, subtree_task &task,
+                 budget_state &budget) {
+  budget_meter meter(&budget);
+  try {
+    try {
+      all_simple_paths_with_prefix(g, task.prefix, stop_vertex, task.paths,
+                                   meter);
+    }
+    catch (budget_exhausted &) {
+    }
+  }
+  catch (...) {
+    // Anything else goes to the waiting thread, which would otherwise wait
+    // forever
+    task.done.set_exception(std::current_exception());
+    return;
+  }
+  task.done.set_value();
+}
+
+// all_simple_paths where the subtrees below the prefixes split_depth edges
+// from start_vertex are searched as independent tasks in pool. The calling
+// thread runs any subtree the pool has not started yet rather than block, and
+// results are merged so paths are in the same order as all_simple_paths.
+//
+// Every task charges the same budget. If it runs out, each task keeps what it
+// found, so the paths are some of those found by all_simple_paths in order,
+// though not necessarily the first ones
+void parallel_all_simple_paths(const Graph_t &g, Vertex_t start_vertex,
+                               Vertex_t stop_vertex,
+                               std::vector<std::vector<std::string> > &paths,
+                               concurrent::ThreadPoolSimple &pool,
+                               std::size_t split_depth, budget_state &budget) {
+  // Expand the top of the search tree in depth first order. A null task is a
+  // path found above split_depth, stored in found
+  std::vector<std::shared_ptr<subtree_task> > tasks;
+  std::vector<std::vector<Vertex_t> > found;
+
+  std::vector<bool> on_branch(num_vertices(g), false);
+  std::vector<Vertex_t> branch{ start_vertex };
+  std::vector<std::pair<boost::graph_traits<Graph_t>::out_edge_iterator,
+                        boost::graph_traits<Graph_t>::out_edge_iterator> >
+  next{ out_edges(start_vertex, g) };
+  on_branch[start_vertex] = true;
+
+  budget_meter meter(&budget);
+  try {
+    while (!branch.empty()) {
+      auto &edges = next.back();
+      if (edges.first == edges.second) {
+        on_branch[branch.back()] = false;
+        branch.pop_back();
+        next.pop_back();
+        continue;
+      }
+
+      Vertex_t v = target(*edges.first++, g);
+      meter.edge();
+      if (v == stop_vertex) {
+        meter.path();
+        found.push_back(branch);
+        found.back().push_back(v);
+        tasks.push_back(nullptr);
+      }
+      if (on_branch[v])
+        continue;
+
+      if (branch.size() == split_depth) {
+        auto task = std::make_shared<subtree_task>();
+        task->prefix = branch;
+        task->prefix.push_back(v);
+        tasks.push_back(task);
+        continue;
+      }
+
+      on_branch[v] = true;
+      branch.push_back(v);
+      next.push_back(out_edges(v, g));
+    }
+  }
+  catch (budget_exhausted &) {
+    // Keep the tasks found so far, they will stop almost immediately
+  }
+
+  std::vector<std::future<void> > results;
+  for (const auto &task : tasks) {
+    if (!task)
+      continue;
+    results.push_back(task->done.get_future());
+    pool.submit([task, &g, stop_vertex, &budget]() {
+      if (!task->claimed.exchange(true))
+        run_subtree(g, stop_vertex, *task, budget);
+    });
+  }
+
+  auto result = results.begin();
+  auto path = found.begin();
+  for (const auto &task : tasks) {
+    if (!task) {
+      std::vector<std::string> names;
+      for (const auto v : *path++)
+        names.push_back(g[v].name);
+      paths.push_back(std::move(names));
+      continue;
+    }
+
+    if (!task->claimed.exchange(true))
+      run_subtree(g, stop_vertex, *task, budget);
+    (result++)->wait();
+
+    for (auto &p : task->paths)
+      paths.push_back(std::move(p));
+  }
+
+  // Only rethrow a task's exception once no task still refers to g or budget
+  for (auto &r : results)
+    r.get();
+}
 }
 
 // NOTE: Keep this function and the one below it in sync
 void graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
                           std::vector<std::vector<std::string> > &paths,
                           Traversal traversal, util::Timer &timer) {
+  budget_meter meter;
   targeted_path_visitor vis(sink, paths);
   switch (traversal) {
   case Traversal::depth_first_search:
@@ -342,7 +994,7 @@ void graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
     break;
   case Traversal::all_simple_paths:
     timer.start();
-    ::all_simple_paths(g, vis, source);
+    ::simple_paths(g, vis, source, sink);
     timer.stop();
     break;
   case Traversal::all_edge_disjoint_paths:
@@ -350,6 +1002,16 @@ void graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
     ::all_edge_disjoint_paths(g, vis, source);
     timer.stop();
     break;
+  case Traversal::all_covering_paths:
+    timer.start();
+    ::all_covering_paths(g, vis, source, sink);
+    timer.stop();
+    break;
+  case Traversal::bidirectional_simple_paths:
+    timer.start();
+    ::bidirectional_simple_paths(g, source, sink, paths, meter);
+    timer.stop();
+    break;
   }
 }
 
@@ -357,18 +1019,188 @@ void graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
 void graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
                           std::vector<std::vector<std::string> > &paths,
                           Traversal traversal) {
-  targeted_path_visitor vis(sink, paths);
-  switch (traversal) {
-  case Traversal::depth_first_search:
-    ::depth_first_search(g, vis, source);
-    break;
-  case Traversal::all_simple_paths:
-    ::all_simple_paths(g, vis, source);
-    break;
-  case Traversal::all_edge_disjoint_paths:
-    ::all_edge_disjoint_paths(g, vis, source);
-    break;
+  run_traversal(g, source, sink, paths, traversal, Budget());
+}
+
+bool graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                          std::vector<std::vector<std::string> > &paths,
+                          Traversal traversal, const Budget &budget) {
+  budget_state state(budget);
+  budget_meter meter(budget.unlimited() ? nullptr : &state);
+  targeted_path_visitor vis(sink, paths, {}, &meter);
+  try {
+    switch (traversal) {
+    case Traversal::depth_first_search:
+      ::depth_first_search(g, vis, source);
+      break;
+    case Traversal::all_simple_paths:
+      ::simple_paths(g, vis, source, sink);
+      break;
+    case Traversal::all_edge_disjoint_paths:
+      ::all_edge_disjoint_paths(g, vis, source);
+      break;
+    case Traversal::all_covering_paths:
+      ::all_covering_paths(g, vis, source, sink);
+      break;
+    case Traversal::bidirectional_simple_paths:
+      ::bidirectional_simple_paths(g, source, sink, paths, meter);
+      break;
+    }
   }
+  catch (budget_exhausted &) {
+    return true;
+  }
+  return false;
+}
+
+bool graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                          const PathVisitor &visitor, Traversal traversal,
+                          const Budget &budget) {
+  typedef boost::color_traits<boost::default_color_type> Color;
+
+  budget_state state(budget);
+  budget_meter meter(budget.unlimited() ? nullptr : &state);
+  bool skip = false;
+  streaming_path_visitor vis(sink, visitor, &skip, &meter);
+  skip_requested func(&skip);
+
+  std::vector<boost::default_color_type> colors(num_vertices(g),
+                                                Color::white());
+  auto color = boost::make_iterator_property_map(colors.begin(),
+                                                 get(boost::vertex_index, g));
+
+  try {
+    switch (traversal) {
+    case Traversal::depth_first_search:
+      boost::detail::depth_first_visit_impl(g, source, vis, color, func);
+      break;
+    case Traversal::all_simple_paths:
+      ::simple_paths(g, vis, source, sink, func);
+      break;
+    case Traversal::all_edge_disjoint_paths:
+      ::all_edge_disjoint_paths(g, vis, source, func);
+      break;
+    case Traversal::all_covering_paths:
+      ::all_covering_paths(g, vis, source, sink, func);
+      break;
+    case Traversal::bidirectional_simple_paths:
+      ::bidirectional_simple_paths(
+          g, source, sink, meter, [&visitor](const std::vector<Vertex_t> &p) {
+            if (visitor.found && visitor.found(p) == Visit::stop)
+              throw traversal_stopped();
+          });
+      break;
+    }
+  }
+  catch (budget_exhausted &) {
+    return true;
+  }
+  catch (traversal_stopped &) {
+    return true;
+  }
+  return false;
+}
+
+bool graph::run_traversal(Graph_t &g, Vertex_t source, Vertex_t sink,
+                          std::vector<std::vector<std::string> > &paths,
+                          Traversal traversal,
+                          concurrent::ThreadPoolSimple &pool,
+                          std::size_t split_depth, const Budget &budget) {
+  if (traversal != Traversal::all_simple_paths || split_depth == 0)
+    return run_traversal(g, source, sink, paths, traversal, budget);
+
+  budget_state state(budget);
+  ::parallel_all_simple_paths(g, source, sink, paths, pool, split_depth,
+                              state);
+  return state.exhausted;
+}
+
+bool graph::best_first_paths(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                             const ExtensionScore &score,
+                             const ScoredPathVisitor &visitor,
+                             const Budget &budget) {
+  // Every partial path searched, each pointing back to the one it extends
+  struct branch_node {
+    Vertex_t vertex;
+    std::size_t parent;
+    double score;
+  };
+  const std::size_t none = static_cast<std::size_t>(-1);
+  std::vector<branch_node> nodes{ { source, none, 0 } };
+
+  // Highest score first, then the earliest found so ties keep out_edges order
+  auto worse = [&nodes](std::size_t a, std::size_t b) {
+    const double x = nodes[a].score, y = nodes[b].score;
+    return x < y || (!(x < y) && !(y < x) && a > b);
+  };
+  std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(worse)>
+      frontier(worse);
+  frontier.push(0);
+
+  budget_state state(budget);
+  budget_meter meter(budget.unlimited() ? nullptr : &state);
+  std::vector<Vertex_t> branch;
+  std::vector<bool> on_branch(num_vertices(g), false);
+
+  try {
+    while (!frontier.empty()) {
+      const std::size_t current = frontier.top();
+      frontier.pop();
+
+      branch.clear();
+      for (std::size_t i = current; i != none; i = nodes[i].parent)
+        branch.push_back(nodes[i].vertex);
+      std::reverse(branch.begin(), branch.end());
+
+      if (branch.back() == sink) {
+        meter.path();
+        if (visitor(branch, nodes[current].score) == Visit::stop)
+          return true;
+        continue;
+      }
+
+      for (const auto v : branch)
+        on_branch[v] = true;
+      boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+      for (boost::tie(ei, ei_end) = out_edges(branch.back(), g); ei != ei_end;
+           ++ei) {
+        meter.edge();
+        const Vertex_t v = target(*ei, g);
+        if (on_branch[v])
+          continue;
+        nodes.push_back({ v, current, nodes[current].score + score(branch, v) });
+        frontier.push(nodes.size() - 1);
+      }
+      for (const auto v : branch)
+        on_branch[v] = false;
+    }
+  }
+  catch (budget_exhausted &) {
+    return true;
+  }
+  return false;
+}
+
+bool graph::best_first_paths(const Graph_t &g, Vertex_t source, Vertex_t sink,
+                             const ExtensionScore &score, std::size_t k,
+                             std::vector<std::vector<std::string> > &paths,
+                             std::vector<double> *scores,
+                             const Budget &budget) {
+  std::size_t found = 0;
+  const bool stopped = best_first_paths(
+      g, source, sink, score,
+      [&](const std::vector<Vertex_t> &path, double path_score) {
+        std::vector<std::string> names;
+        for (const auto v : path)
+          names.push_back(g[v].name);
+        paths.push_back(std::move(names));
+        if (scores)
+          scores->push_back(path_score);
+        return ++found == k ? Visit::stop : Visit::proceed;
+      },
+      budget);
+  // Finding all k paths asked for isn't stopping early
+  return stopped && found != k;
 }
 
 std::ostream &graph::operator<<(std::ostream &out, const Traversal traversal) {
@@ -382,6 +1214,12 @@ std::ostream &graph::operator<<(std::ostream &out, const Traversal traversal) {
     case Traversal::all_edge_disjoint_paths:
       out << "All edge-disjoint paths";
       break;
+    case Traversal::all_covering_paths:
+      out << "All covering paths";
+      break;
+    case Traversal::bidirectional_simple_paths:
+      out << "Bidirectional simple paths";
+      break;
   }
   return out;
 }
@@ -0,0 +1,109 @@
+//===-- graph/Trim.cpp - Remove vertices off every path --------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a pass removing vertices that cannot lie on any
+// source to sink path
+//
+//===----------------------------------------------------------------------===//
+
+#include "graph/Trim.h"
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+
+#include "graph/Graph.h"
+using graph::Graph_t;
+using graph::Vertex_t;
+
+namespace {
+// Marks everything reachable from start following adjacency
+void mark_reachable(const std::vector<std::vector<Vertex_t> > &adjacency,
+                    Vertex_t start, std::vector<bool> &reached) {
+  std::vector<Vertex_t> pending{ start };
+  reached[start] = true;
+
+  while (!pending.empty()) {
+    Vertex_t u = pending.back();
+    pending.pop_back();
+    for (const auto v : adjacency[u]) {
+      if (!reached[v]) {
+        reached[v] = true;
+        pending.push_back(v);
+      }
+    }
+  }
+}
+}
+
+std::size_t graph::trim(Graph_t &g, Vertex_t source, Vertex_t sink) {
+  const std::size_t n = num_vertices(g);
+
+  std::vector<std::vector<Vertex_t> > forward(n);
+  std::vector<std::vector<Vertex_t> > backward(n);
+  for (Vertex_t u = 0; u < n; ++u) {
+    boost::graph_traits<Graph_t>::out_edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = out_edges(u, g); ei != ei_end; ++ei) {
+      forward[u].push_back(target(*ei, g));
+      backward[target(*ei, g)].push_back(u);
+    }
+  }
+
+  std::vector<bool> from_source(n, false);
+  std::vector<bool> to_sink(n, false);
+  mark_reachable(forward, source, from_source);
+  mark_reachable(backward, sink, to_sink);
+
+  // Source and sink are always kept so the result is still usable even if no
+  // path exists
+  std::vector<Vertex_t> renumbered(n);
+  std::size_t kept = 0;
+  for (Vertex_t v = 0; v < n; ++v) {
+    if ((from_source[v] && to_sink[v]) || v == source || v == sink)
+      renumbered[v] = kept++;
+    else
+      renumbered[v] = n;
+  }
+
+  if (kept == n)
+    return 0;
+
+  Graph_t trimmed(kept);
+  trimmed[boost::graph_bundle] = g[boost::graph_bundle];
+  for (Vertex_t v = 0; v < n; ++v)
+    if (renumbered[v] != n)
+      trimmed[renumbered[v]] = g[v];
+
+  // Visit edges by source vertex so each out edge list keeps its order
+  std::size_t edge_index = 0;
+  for (Vertex_t u = 0; u < n; ++u) {
+    if (renumbered[u] == n)
+      continue;
+    boost::graph_traits<Graph_t>::out_edge_iterator oi, oi_end;
+    for (boost::tie(oi, oi_end) = out_edges(u, g); oi != oi_end; ++oi) {
+      Vertex_t v = target(*oi, g);
+      if (renumbered[v] != n)
+        boost::add_edge(renumbered[u], renumbered[v], edge_index++, trimmed);
+    }
+  }
+
+  g.swap(trimmed);
+
+  return n - kept;
+}
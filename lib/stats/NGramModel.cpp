@@ -0,0 +1,187 @@
+//===-- stats/NGramModel.cpp - Character n-gram language model --*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the character n-gram language model
+//
+//===----------------------------------------------------------------------===//
+
+#include "stats/NGramModel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+using std::size_t;
+using std::string;
+
+namespace {
+const char magic[4] = { 'N', 'G', 'M', '1' };
+
+// The most n-grams a model read from a file may count, 1 GiB of counts.
+// Anything larger is taken as a corrupt header rather than allocated
+const size_t max_counts = static_cast<size_t>(1) << 28;
+
+// Whether a model of order over an alphabet of length symbols has at most
+// max_counts n-grams, checked without overflowing
+bool counts_fit(size_t order, size_t length) {
+  size_t result = 1;
+  for (size_t i = 0; i < order; ++i) {
+    if (result > max_counts / (length + 1))
+      return false;
+    result *= length + 1;
+  }
+  return true;
+}
+
+size_t power(size_t base, size_t exponent) {
+  size_t result = 1;
+  for (size_t i = 0; i < exponent; ++i)
+    result *= base;
+  return result;
+}
+
+template <typename T> void write_raw(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T> bool read_raw(std::istream &in, T &value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(&value),
+                                   sizeof(value)));
+}
+}
+
+stats::NGramModel::NGramModel() : n(0), symbols(), alpha(1) { build_index(); }
+
+stats::NGramModel::NGramModel(size_t order, const string &alphabet,
+                              double smoothing)
+    : n(order), symbols(alphabet), alpha(smoothing) {
+  assert(order != 0 && "An n-gram needs at least one character");
+  build_index();
+  counts.assign(power(symbols.size() + 1, n), 0);
+  totals.assign(power(symbols.size() + 1, n - 1), 0);
+}
+
+void stats::NGramModel::build_index() {
+  index.fill(0);
+  for (size_t i = 0; i < symbols.size(); ++i)
+    index[static_cast<unsigned char>(symbols[i])] =
+        static_cast<std::uint32_t>(i + 1);
+}
+
+size_t stats::NGramModel::symbol(char c) const {
+  return index[static_cast<unsigned char>(c)];
+}
+
+size_t stats::NGramModel::context(const string &history) const {
+  // Positions before the start of history are the start sentinel
+  const size_t width = symbols.size() + 1;
+  size_t ctx = 0;
+  for (size_t i = 0; i + 1 < n; ++i) {
+    const size_t back = n - 1 - i;
+    ctx = ctx * width +
+          (back <= history.size() ? symbol(history[history.size() - back]) : 0);
+  }
+  return ctx;
+}
+
+void stats::NGramModel::add(const string &word) {
+  const size_t width = symbols.size() + 1;
+  for (size_t i = 0; i <= word.size(); ++i) {
+    const size_t ctx = context(word.substr(0, i));
+    const size_t next = i < word.size() ? symbol(word[i]) : 0;
+    ++counts[ctx * width + next];
+    ++totals[ctx];
+  }
+}
+
+double stats::NGramModel::log_probability(size_t ctx, size_t next) const {
+  const double width = static_cast<double>(symbols.size() + 1);
+  const double seen =
+      static_cast<double>(counts[ctx * (symbols.size() + 1) + next]);
+  return std::log((seen + alpha) /
+                  (static_cast<double>(totals[ctx]) + alpha * width));
+}
+
+double stats::NGramModel::log_probability(const string &history,
+                                          char next) const {
+  const size_t ctx = context(history);
+  const size_t s = symbol(next);
+  // Unknown characters are unseen, even if the sentinel has been seen here
+  if (s == 0)
+    return std::log(alpha / (static_cast<double>(totals[ctx]) +
+                             alpha * static_cast<double>(symbols.size() + 1)));
+  return log_probability(ctx, s);
+}
+
+double stats::NGramModel::log_probability_end(const string &history) const {
+  return log_probability(context(history), 0);
+}
+
+double stats::NGramModel::log_probability(const string &word) const {
+  double total = 0;
+  for (size_t i = 0; i < word.size(); ++i)
+    total += log_probability(word.substr(0, i), word[i]);
+  return total + log_probability_end(word);
+}
+
+void stats::NGramModel::write(std::ostream &out) const {
+  out.write(magic, sizeof(magic));
+  write_raw(out, static_cast<std::uint32_t>(n));
+  write_raw(out, static_cast<std::uint32_t>(symbols.size()));
+  out.write(symbols.data(), static_cast<std::streamsize>(symbols.size()));
+  write_raw(out, alpha);
+  out.write(reinterpret_cast<const char *>(counts.data()),
+            static_cast<std::streamsize>(counts.size() * sizeof(counts[0])));
+}
+
+bool stats::NGramModel::read(std::istream &in) {
+  *this = NGramModel();
+
+  char header[sizeof(magic)];
+  std::uint32_t order, length;
+  if (!in.read(header, sizeof(header)) ||
+      !std::equal(header, header + sizeof(header), magic) ||
+      !read_raw(in, order) || order == 0 || !read_raw(in, length) ||
+      length > 255 || !counts_fit(order, length))
+    return false;
+
+  string alphabet(length, '\0');
+  double smoothing;
+  if (!in.read(&alphabet[0], static_cast<std::streamsize>(length)) ||
+      !read_raw(in, smoothing))
+    return false;
+
+  NGramModel model(order, alphabet, smoothing);
+  if (!in.read(reinterpret_cast<char *>(model.counts.data()),
+               static_cast<std::streamsize>(model.counts.size() *
+                                            sizeof(model.counts[0]))))
+    return false;
+
+  const size_t width = alphabet.size() + 1;
+  for (size_t i = 0; i < model.counts.size(); ++i)
+    model.totals[i / width] += model.counts[i];
+
+  *this = std::move(model);
+  return true;
+}
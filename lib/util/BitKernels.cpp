@@ -0,0 +1,303 @@
+//===-- util/BitKernels.cpp - Word level bit counting kernels ---*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains population counts over arrays of 64-bit words
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/BitKernels.h"
+
+#include <cstddef>
+#include <ostream>
+
+#if defined(X86_BIT_KERNELS)
+#include <immintrin.h>
+#endif
+
+using std::size_t;
+
+namespace {
+using util::BitKernel;
+using util::Word;
+
+struct Kernels {
+  size_t (*count)(const Word *, size_t);
+  size_t (*count_and)(const Word *, const Word *, size_t);
+  size_t (*count_or)(const Word *, const Word *, size_t);
+};
+
+size_t count_generic(const Word *a, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i]));
+  return total;
+}
+
+size_t count_and_generic(const Word *a, const Word *b, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] & b[i]));
+  return total;
+}
+
+size_t count_or_generic(const Word *a, const Word *b, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] | b[i]));
+  return total;
+}
+
+#if defined(X86_BIT_KERNELS)
+// The generic loops again, but with the popcnt instruction available
+__attribute__((target("popcnt"))) size_t count_popcnt(const Word *a,
+                                                      size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i]));
+  return total;
+}
+
+__attribute__((target("popcnt"))) size_t
+count_and_popcnt(const Word *a, const Word *b, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] & b[i]));
+  return total;
+}
+
+__attribute__((target("popcnt"))) size_t
+count_or_popcnt(const Word *a, const Word *b, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] | b[i]));
+  return total;
+}
+
+// AVX2 has no population count, so count each nibble with a table lookup in
+// a shuffle and sum the bytes with sad (Mula, Kurz & Lemire 2018)
+__attribute__((target("avx2,popcnt"))) __m256i count_bytes_avx2(__m256i v) {
+  const __m256i table =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+
+  const __m256i low = _mm256_and_si256(v, low_nibbles);
+  const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+  const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, low),
+                                        _mm256_shuffle_epi8(table, high));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2,popcnt"))) size_t sum_avx2(__m256i sums) {
+  return static_cast<size_t>(_mm256_extract_epi64(sums, 0)) +
+         static_cast<size_t>(_mm256_extract_epi64(sums, 1)) +
+         static_cast<size_t>(_mm256_extract_epi64(sums, 2)) +
+         static_cast<size_t>(_mm256_extract_epi64(sums, 3));
+}
+
+__attribute__((target("avx2,popcnt"))) size_t count_avx2(const Word *a,
+                                                         size_t n) {
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    sums = _mm256_add_epi64(sums, count_bytes_avx2(v));
+  }
+
+  size_t total = sum_avx2(sums);
+  for (; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i]));
+  return total;
+}
+
+__attribute__((target("avx2,popcnt"))) size_t
+count_and_avx2(const Word *a, const Word *b, size_t n) {
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i v = _mm256_and_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    sums = _mm256_add_epi64(sums, count_bytes_avx2(v));
+  }
+
+  size_t total = sum_avx2(sums);
+  for (; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] & b[i]));
+  return total;
+}
+
+__attribute__((target("avx2,popcnt"))) size_t
+count_or_avx2(const Word *a, const Word *b, size_t n) {
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i v = _mm256_or_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    sums = _mm256_add_epi64(sums, count_bytes_avx2(v));
+  }
+
+  size_t total = sum_avx2(sums);
+  for (; i < n; ++i)
+    total += static_cast<size_t>(__builtin_popcountll(a[i] | b[i]));
+  return total;
+}
+
+// AVX-512 counts eight words at once, and masked loads handle the tail
+__attribute__((target("avx512f"))) size_t sum_avx512(__m512i sums) {
+  Word lanes[8];
+  _mm512_storeu_si512(lanes, sums);
+  size_t total = 0;
+  for (const Word lane : lanes)
+    total += static_cast<size_t>(lane);
+  return total;
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) size_t
+count_avx512(const Word *a, size_t n) {
+  __m512i sums = _mm512_setzero_si512();
+  for (size_t i = 0; i < n; i += 8) {
+    const __mmask8 mask = static_cast<__mmask8>(
+        n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+    const __m512i v = _mm512_maskz_loadu_epi64(mask, a + i);
+    sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(v));
+  }
+  return sum_avx512(sums);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) size_t
+count_and_avx512(const Word *a, const Word *b, size_t n) {
+  __m512i sums = _mm512_setzero_si512();
+  for (size_t i = 0; i < n; i += 8) {
+    const __mmask8 mask = static_cast<__mmask8>(
+        n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+    const __m512i v = _mm512_and_si512(_mm512_maskz_loadu_epi64(mask, a + i),
+                                       _mm512_maskz_loadu_epi64(mask, b + i));
+    sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(v));
+  }
+  return sum_avx512(sums);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) size_t
+count_or_avx512(const Word *a, const Word *b, size_t n) {
+  __m512i sums = _mm512_setzero_si512();
+  for (size_t i = 0; i < n; i += 8) {
+    const __mmask8 mask = static_cast<__mmask8>(
+        n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+    const __m512i v = _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, a + i),
+                                      _mm512_maskz_loadu_epi64(mask, b + i));
+    sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(v));
+  }
+  return sum_avx512(sums);
+}
+#endif
+
+Kernels kernels_for(const BitKernel kernel) {
+  switch (kernel) {
+#if defined(X86_BIT_KERNELS)
+  case BitKernel::popcnt:
+    return { count_popcnt, count_and_popcnt, count_or_popcnt };
+  case BitKernel::avx2:
+    return { count_avx2, count_and_avx2, count_or_avx2 };
+  case BitKernel::avx512:
+    return { count_avx512, count_and_avx512, count_or_avx512 };
+#else
+  case BitKernel::popcnt:
+  case BitKernel::avx2:
+  case BitKernel::avx512:
+#endif
+  case BitKernel::generic:
+    break;
+  }
+  return { count_generic, count_and_generic, count_or_generic };
+}
+
+BitKernel best_bit_kernel() {
+  for (const BitKernel kernel :
+       { BitKernel::avx512, BitKernel::avx2, BitKernel::popcnt })
+    if (util::bit_kernel_supported(kernel))
+      return kernel;
+  return BitKernel::generic;
+}
+
+BitKernel &active_kernel() {
+  static BitKernel kernel = best_bit_kernel();
+  return kernel;
+}
+
+Kernels &active_kernels() {
+  static Kernels kernels = kernels_for(active_kernel());
+  return kernels;
+}
+}
+
+std::ostream &util::operator<<(std::ostream &out, const BitKernel kernel) {
+  switch (kernel) {
+  case BitKernel::generic:
+    return out << "generic";
+  case BitKernel::popcnt:
+    return out << "popcnt";
+  case BitKernel::avx2:
+    return out << "AVX2";
+  case BitKernel::avx512:
+    return out << "AVX-512";
+  }
+  return out;
+}
+
+bool util::bit_kernel_supported(const BitKernel kernel) {
+  switch (kernel) {
+  case BitKernel::generic:
+    return true;
+#if defined(X86_BIT_KERNELS)
+  case BitKernel::popcnt:
+    return __builtin_cpu_supports("popcnt");
+  case BitKernel::avx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+  case BitKernel::avx512:
+    return __builtin_cpu_supports("avx512f") &&
+           __builtin_cpu_supports("avx512vpopcntdq");
+#endif
+  default:
+    return false;
+  }
+}
+
+util::BitKernel util::bit_kernel() { return active_kernel(); }
+
+bool util::force_bit_kernel(const BitKernel kernel) {
+  if (!bit_kernel_supported(kernel))
+    return false;
+  active_kernel() = kernel;
+  active_kernels() = kernels_for(kernel);
+  return true;
+}
+
+size_t util::count(const Word *a, size_t n) {
+  return active_kernels().count(a, n);
+}
+
+size_t util::count_and(const Word *a, const Word *b, size_t n) {
+  return active_kernels().count_and(a, b, n);
+}
+
+size_t util::count_or(const Word *a, const Word *b, size_t n) {
+  return active_kernels().count_or(a, b, n);
+}
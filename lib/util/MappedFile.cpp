@@ -0,0 +1,74 @@
+//===-- util/MappedFile.cpp - Read only file mapping ------------*- C++ -*-===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains a read only mapping of a whole file into memory
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/MappedFile.h"
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(POSIX_MAPPING)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+util::MappedFile::MappedFile(const std::string &filename)
+    : contents(nullptr), length(0) {
+#if defined(POSIX_MAPPING)
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    void *mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                        PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped != MAP_FAILED) {
+      contents = mapped;
+      length = static_cast<std::size_t>(info.st_size);
+    }
+  }
+  // The mapping stays valid after the file is closed
+  close(fd);
+#else
+  std::ifstream in(filename, std::ios::binary);
+  if (!in)
+    return;
+  fallback.assign(std::istreambuf_iterator<char>(in),
+                  std::istreambuf_iterator<char>());
+  if (!fallback.empty()) {
+    contents = fallback.data();
+    length = fallback.size();
+  }
+#endif
+}
+
+util::MappedFile::~MappedFile() {
+#if defined(POSIX_MAPPING)
+  if (contents)
+    munmap(const_cast<void *>(contents), length);
+#endif
+}
@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+#include <sstream>
+using std::stringstream;
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "adt/AdaptiveBitset.h"
+using adt::AdaptiveBitset;
+
+TEST(AdaptiveBitset, SparseToDense) {
+  AdaptiveBitset bits(6400);
+  EXPECT_EQ(6400u, bits.size());
+  EXPECT_TRUE(bits.is_sparse());
+  EXPECT_EQ(200u, bits.sparse_limit());
+  EXPECT_TRUE(bits.none());
+
+  bits.set(5).set(5).set(6399).set(0);
+  EXPECT_TRUE(bits.is_sparse());
+  EXPECT_EQ(3u, bits.count());
+  EXPECT_TRUE(bits[0]);
+  EXPECT_TRUE(bits.test(5));
+  EXPECT_TRUE(bits[6399]);
+  EXPECT_FALSE(bits[6]);
+
+  bits.reset(5).reset(6);
+  EXPECT_EQ(2u, bits.count());
+
+  // One past the limit switches to words, keeping every bit
+  for (size_t i = 0; i < 200; ++i)
+    bits.set(i * 31 + 1);
+  EXPECT_FALSE(bits.is_sparse());
+  EXPECT_EQ(202u, bits.count());
+  EXPECT_TRUE(bits[0]);
+  EXPECT_TRUE(bits[32]);
+  EXPECT_TRUE(bits[6399]);
+  EXPECT_FALSE(bits[2]);
+
+  vector<size_t> positions;
+  bits.for_each_set([&positions](size_t p) { positions.push_back(p); });
+  ASSERT_EQ(202u, positions.size());
+  EXPECT_EQ(0u, positions.front());
+  EXPECT_EQ(1u, positions[1]);
+  EXPECT_EQ(6399u, positions.back());
+}
+
+TEST(AdaptiveBitset, EqualityAndIntersection) {
+  AdaptiveBitset sparse(6400), other(6400), dense(6400);
+  for (size_t i = 0; i < 10; ++i) {
+    sparse.set(i * 100);
+    other.set(i * 200);
+  }
+  for (size_t i = 0; i < 300; ++i)
+    dense.set(i * 20);
+  ASSERT_TRUE(sparse.is_sparse());
+  ASSERT_FALSE(dense.is_sparse());
+
+  EXPECT_EQ(5u, intersection_count(sparse, other));
+  EXPECT_EQ(10u, intersection_count(sparse, dense));
+  EXPECT_EQ(10u, intersection_count(dense, sparse));
+  EXPECT_EQ(300u, intersection_count(dense, dense));
+
+  EXPECT_NE(sparse, other);
+  EXPECT_NE(sparse, dense);
+
+  // The same bits compare equal whichever way they are kept
+  AdaptiveBitset as_dense(6400);
+  for (size_t i = 0; i < 300; ++i)
+    as_dense.set(i * 20);
+  for (size_t i = 0; i < 300; ++i)
+    as_dense.reset(i * 20);
+  for (size_t i = 0; i < 10; ++i)
+    as_dense.set(i * 100);
+  ASSERT_FALSE(as_dense.is_sparse());
+  EXPECT_EQ(sparse, as_dense);
+  EXPECT_EQ(as_dense, sparse);
+  EXPECT_NE(AdaptiveBitset(10), AdaptiveBitset(11));
+}
+
+TEST(AdaptiveBitset, ReadWrite) {
+  AdaptiveBitset sparse(100000), dense(64);
+  sparse.set(1).set(50000).set(99999);
+  dense.set(0).set(1).set(2).set(63);
+  ASSERT_FALSE(dense.is_sparse());
+
+  stringstream stream;
+  ASSERT_TRUE(sparse.write(stream));
+  ASSERT_TRUE(dense.write(stream));
+
+  AdaptiveBitset read;
+  ASSERT_TRUE(read.read(stream));
+  EXPECT_EQ(sparse, read);
+  EXPECT_TRUE(read.is_sparse());
+  ASSERT_TRUE(read.read(stream));
+  EXPECT_EQ(dense, read);
+  EXPECT_FALSE(read.is_sparse());
+
+  EXPECT_FALSE(read.read(stream));
+}
+
+TEST(AdaptiveBitset, ReadRejectsBadHeaders) {
+  AdaptiveBitset kept(64);
+  kept.set(3);
+
+  // More positions than bits
+  {
+    stringstream stream;
+    const std::uint64_t header[2] = { 4, 5 };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    AdaptiveBitset read(kept);
+    EXPECT_FALSE(read.read(stream));
+    EXPECT_EQ(kept, read);
+  }
+  // A size past 32-bit positions
+  {
+    stringstream stream;
+    const std::uint64_t header[2] = { std::uint64_t(UINT32_MAX) + 2, 0 };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    AdaptiveBitset read(kept);
+    EXPECT_FALSE(read.read(stream));
+    EXPECT_EQ(kept, read);
+  }
+  // A position out of range leaves the bitset as it was
+  {
+    stringstream stream;
+    const std::uint64_t header[2] = { 10, 2 };
+    const AdaptiveBitset::position_type set[2] = { 1, 10 };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(set), sizeof(set));
+    AdaptiveBitset read(kept);
+    EXPECT_FALSE(read.read(stream));
+    EXPECT_EQ(kept, read);
+  }
+  // Positions out of order
+  {
+    stringstream stream;
+    const std::uint64_t header[2] = { 10, 2 };
+    const AdaptiveBitset::position_type set[2] = { 4, 4 };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(set), sizeof(set));
+    AdaptiveBitset read(kept);
+    EXPECT_FALSE(read.read(stream));
+    EXPECT_EQ(kept, read);
+  }
+  // A count far past the data there is fails without reserving for it
+  {
+    stringstream stream;
+    const std::uint64_t header[2] = { std::uint64_t(UINT32_MAX) + 1,
+                                      UINT32_MAX };
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    AdaptiveBitset read(kept);
+    EXPECT_FALSE(read.read(stream));
+    EXPECT_EQ(kept, read);
+  }
+}
+
+TEST(AdaptiveBitset, AsDynamicBitset) {
+  AdaptiveBitset sparse(100000), dense(64);
+  sparse.set(1).set(50000).set(99999);
+  dense.set(0).set(1).set(2).set(63);
+
+  boost::dynamic_bitset<> expected(100000);
+  expected.set(1).set(50000).set(99999);
+  EXPECT_EQ(expected, as_dynamic_bitset(sparse));
+
+  expected.clear();
+  expected.resize(64);
+  expected.set(0).set(1).set(2).set(63);
+  EXPECT_EQ(expected, as_dynamic_bitset(dense));
+}
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+using std::uintptr_t;
+#include <vector>
+using std::vector;
+
+#include "adt/AlignedBitset.h"
+using adt::AlignedBitset;
+
+TEST(AlignedBitset, Layout) {
+  AlignedBitset empty;
+  EXPECT_EQ(0u, empty.size());
+  EXPECT_EQ(0u, empty.num_blocks());
+  EXPECT_TRUE(empty.none());
+
+  // Whole 64 byte lines, starting on a line
+  for (const unsigned int m : { 1u, 64u, 100u, 512u, 513u, 1000u }) {
+    AlignedBitset bits(m);
+    EXPECT_EQ(m, bits.size());
+    EXPECT_EQ(0u, bits.num_blocks() % 8);
+    EXPECT_GE(bits.num_blocks() * 64, m);
+    EXPECT_LT(bits.num_blocks() * 64, m + 512);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(bits.data()) % 64);
+  }
+}
+
+TEST(AlignedBitset, SetTest) {
+  AlignedBitset bits(1000);
+  bits.set(0).set(63).set(64).set(999);
+  EXPECT_TRUE(bits.test(0));
+  EXPECT_TRUE(bits[63]);
+  EXPECT_TRUE(bits[64]);
+  EXPECT_TRUE(bits[999]);
+  EXPECT_FALSE(bits[1]);
+  EXPECT_EQ(4u, bits.count());
+  EXPECT_TRUE(bits.any());
+
+  bits.reset(63);
+  EXPECT_FALSE(bits[63]);
+  EXPECT_EQ(3u, bits.count());
+
+  const vector<unsigned int> positions = { 5, 500, 700 };
+  EXPECT_FALSE(bits.test_all(positions.begin(), positions.end()));
+  bits.set_all(positions.begin(), positions.end());
+  EXPECT_TRUE(bits.test_all(positions.begin(), positions.end()));
+  EXPECT_EQ(6u, bits.count());
+
+  const util::BitsetBlocks words = blocks(bits);
+  EXPECT_EQ(bits.data(), words.data);
+  EXPECT_EQ(16u, words.size);
+  EXPECT_EQ(1u | (1u << 5), words.data[0]);
+  for (std::size_t i = 0, e = words.size; i < e; ++i) {
+    if (i != 0 && i != 1 && i != 7 && i != 10 && i != 15) {
+      EXPECT_EQ(0u, words.data[i]);
+    }
+  }
+}
+
+TEST(AlignedBitset, Operators) {
+  AlignedBitset a(200), b(200);
+  a.set(1).set(70).set(150);
+  b.set(70).set(150).set(199);
+
+  EXPECT_NE(a, b);
+  EXPECT_EQ(2u, (a & b).count());
+  EXPECT_EQ(4u, (a | b).count());
+
+  AlignedBitset c(a);
+  EXPECT_EQ(a, c);
+  c ^= b;
+  EXPECT_EQ(2u, c.count());
+  EXPECT_TRUE(c[1]);
+  EXPECT_TRUE(c[199]);
+
+  c &= a;
+  AlignedBitset only(200);
+  only.set(1);
+  EXPECT_EQ(only, c);
+
+  // Same bits, different length
+  EXPECT_NE(AlignedBitset(200), AlignedBitset(201));
+}
@@ -1698,3 +1698,45 @@ TYPED_TEST(BitTupleTest, SymmetricDifferenceFree) {
   EXPECT_TRUE(b.none());
   EXPECT_TRUE(c.all());
 }
+
+TYPED_TEST(BitTupleTest, CountAndOr) {
+  // Small
+  BitTuple<TypeParam> a(20), b(20);
+  a.set(0, 10);
+  b.set(5, 15);
+
+  EXPECT_EQ(5, count_and(a, b));
+  EXPECT_EQ(15, count_or(a, b));
+  EXPECT_EQ((a & b).count(), count_and(a, b));
+  EXPECT_EQ((a | b).count(), count_or(a, b));
+
+  // Large, spanning several words of every Storage (but within uint8_t)
+  BitTuple<TypeParam> c(250), d(250);
+  c.set(0, 150);
+  d.set(100, 240);
+
+  EXPECT_EQ(50, count_and(c, d));
+  EXPECT_EQ(240, count_or(c, d));
+  EXPECT_EQ((c & d).count(), count_and(c, d));
+  EXPECT_EQ((c | d).count(), count_or(c, d));
+  EXPECT_EQ(150, count_and(c, c));
+  EXPECT_EQ(150, count_or(c, c));
+}
+
+TYPED_TEST(BitTupleTest, SelfOperations) {
+  BitTuple<TypeParam> a(250);
+  a.set(7).set(100).set(249);
+  const BitTuple<TypeParam> original(a);
+
+  a &= a;
+  EXPECT_EQ(original, a);
+  a |= a;
+  EXPECT_EQ(original, a);
+  a ^= a;
+  EXPECT_TRUE(a.none());
+
+  a = original;
+  a -= a;
+  EXPECT_TRUE(a.none());
+  EXPECT_EQ(250, a.size());
+}
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <string>
+using std::string;
+#include <utility>
+using std::move;
+#include <vector>
+using std::vector;
+
+#include "adt/CandidateSet.h"
+using adt::CandidateSet;
+
+TEST(CandidateSet, InsertLookup) {
+  CandidateSet set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(""));
+
+  EXPECT_TRUE(set.insert("mipi"));
+  EXPECT_TRUE(set.insert("mi"));
+  EXPECT_TRUE(set.insert("mipissi"));
+  EXPECT_FALSE(set.insert("mipi"));
+  EXPECT_TRUE(set.insert("si"));
+  EXPECT_EQ(4u, set.size());
+  // Root, m, mi, mip, mipi, mipis, mipiss, mipissi, s, si
+  EXPECT_EQ(10u, set.node_count());
+
+  for (const string word : { "mi", "mipi", "mipissi", "si" })
+    EXPECT_TRUE(set.contains(word)) << word;
+  for (const string word : { "", "m", "mip", "mipis", "s", "sis" })
+    EXPECT_FALSE(set.contains(word)) << word;
+
+  // Insertion order is kept
+  vector<string> expected{ "mipi", "mi", "mipissi", "si" };
+  EXPECT_EQ(expected, set.to_vector());
+  EXPECT_EQ("mipissi", set[2]);
+
+  // The empty string is a member like any other
+  EXPECT_TRUE(set.insert(""));
+  EXPECT_TRUE(set.contains(""));
+  EXPECT_EQ("", set[4]);
+  EXPECT_EQ(10u, set.node_count());
+}
+
+TEST(CandidateSet, MoveClear) {
+  CandidateSet set;
+  set.insert("ann");
+  set.insert("anna");
+
+  CandidateSet moved(move(set));
+  EXPECT_EQ(2u, moved.size());
+  EXPECT_TRUE(moved.contains("anna"));
+
+  moved.clear();
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(1u, moved.node_count());
+  EXPECT_FALSE(moved.contains("ann"));
+  EXPECT_TRUE(moved.insert("ann"));
+}
+
+TEST(CandidateSet, Retain) {
+  CandidateSet set;
+  for (const char *word : { "mipi", "mi", "mipissi", "si" })
+    set.insert(word);
+
+  // Kept in order. The nodes of mipi are all on mipissi, so stay
+  set.retain([](const string &word) { return word.size() != 4; });
+  vector<string> expected{ "mi", "mipissi", "si" };
+  EXPECT_EQ(expected, set.to_vector());
+  EXPECT_FALSE(set.contains("mipi"));
+  EXPECT_EQ(10u, set.node_count());
+
+  // Dropping mipissi frees the nodes past mi
+  set.retain([](const string &word) { return word.size() < 4; });
+  expected = { "mi", "si" };
+  EXPECT_EQ(expected, set.to_vector());
+  EXPECT_EQ(5u, set.node_count());
+}
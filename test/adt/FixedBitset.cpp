@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include "adt/FixedBitset.h"
+using adt::FixedBitset;
+
+TEST(FixedBitset, SetTest) {
+  FixedBitset<200> bits(200);
+  EXPECT_EQ(200u, bits.size());
+  EXPECT_EQ(4u, bits.num_blocks());
+  EXPECT_TRUE(bits.none());
+
+  bits.set(0).set(63).set(64).set(199);
+  EXPECT_TRUE(bits[0]);
+  EXPECT_TRUE(bits.test(63));
+  EXPECT_TRUE(bits[64]);
+  EXPECT_TRUE(bits[199]);
+  EXPECT_FALSE(bits[1]);
+  EXPECT_EQ(4u, bits.count());
+
+  bits.reset(63);
+  EXPECT_FALSE(bits[63]);
+  EXPECT_EQ(3u, bits.count());
+
+  const util::BitsetBlocks words = blocks(bits);
+  EXPECT_EQ(bits.data(), words.data);
+  EXPECT_EQ(4u, words.size);
+  EXPECT_EQ(1u, words.data[0]);
+  EXPECT_EQ(util::Word(1) << 7, words.data[3]);
+
+  const boost::dynamic_bitset<> dynamic = util::as_dynamic_bitset(bits);
+  EXPECT_EQ(200u, dynamic.size());
+  EXPECT_EQ(3u, dynamic.count());
+  EXPECT_TRUE(dynamic[199]);
+}
+
+TEST(FixedBitset, Operators) {
+  FixedBitset<200> a, b;
+  a.set(1).set(70).set(150);
+  b.set(70).set(150).set(199);
+
+  EXPECT_NE(a, b);
+  EXPECT_EQ(2u, (a & b).count());
+  EXPECT_EQ(4u, (a | b).count());
+
+  FixedBitset<200> c(a);
+  EXPECT_EQ(a, c);
+  c ^= b;
+  EXPECT_EQ(2u, c.count());
+  c &= a;
+  EXPECT_EQ(1u, c.count());
+  EXPECT_TRUE(c[1]);
+}
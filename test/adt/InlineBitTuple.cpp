@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <utility>
+using std::move;
+
+#include "adt/InlineBitTuple.h"
+using adt::InlineBitTuple;
+
+TEST(InlineBitTuple, InlineAndSpilled) {
+  InlineBitTuple<2> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(empty.isInline());
+  EXPECT_EQ(0u, empty.count());
+
+  InlineBitTuple<2> small(128);
+  EXPECT_TRUE(small.isInline());
+  EXPECT_EQ(128u, small.size());
+  EXPECT_EQ(2u, small.num_blocks());
+  EXPECT_TRUE(small.none());
+
+  InlineBitTuple<2> large(129, true);
+  EXPECT_FALSE(large.isInline());
+  EXPECT_EQ(129u, large.count());
+  EXPECT_EQ(3u, large.num_blocks());
+  // Bits past the end stay clear
+  EXPECT_EQ(1u, large.data()[2]);
+}
+
+TEST(InlineBitTuple, Resize) {
+  InlineBitTuple<2> x(10, true);
+  EXPECT_EQ(10u, x.count());
+
+  // inline to heap, filling
+  x.resize(200, true);
+  EXPECT_FALSE(x.isInline());
+  EXPECT_EQ(200u, x.count());
+
+  // heap to heap, without filling
+  x.resize(300);
+  EXPECT_FALSE(x.isInline());
+  EXPECT_EQ(200u, x.count());
+  EXPECT_TRUE(x.test(199));
+  EXPECT_FALSE(x.test(200));
+
+  // heap to inline
+  x.resize(70);
+  EXPECT_TRUE(x.isInline());
+  EXPECT_EQ(70u, x.count());
+
+  // inline shrink then grow without filling leaves the new bits clear
+  x.resize(5);
+  x.resize(100);
+  EXPECT_EQ(5u, x.count());
+  x.resize(120, true);
+  EXPECT_EQ(25u, x.count());
+}
+
+TEST(InlineBitTuple, SetResetFlip) {
+  for (const std::size_t bits : { 100u, 1000u }) {
+    InlineBitTuple<4> x(bits);
+    x.set(0).set(63).set(64).set(bits - 1);
+    EXPECT_TRUE(x[0]);
+    EXPECT_TRUE(x[63]);
+    EXPECT_TRUE(x[64]);
+    EXPECT_TRUE(x[bits - 1]);
+    EXPECT_FALSE(x[1]);
+    EXPECT_EQ(4u, x.count());
+    EXPECT_TRUE(x.any());
+
+    x.reset(63).flip(1).flip(0);
+    EXPECT_FALSE(x[63]);
+    EXPECT_TRUE(x[1]);
+    EXPECT_FALSE(x[0]);
+    EXPECT_EQ(3u, x.count());
+
+    x.set();
+    EXPECT_EQ(bits, x.count());
+    x.reset();
+    EXPECT_TRUE(x.none());
+  }
+}
+
+TEST(InlineBitTuple, CopyMove) {
+  for (const std::size_t bits : { 100u, 1000u }) {
+    InlineBitTuple<4> a(bits);
+    a.set(3).set(bits - 2);
+
+    InlineBitTuple<4> copy(a);
+    EXPECT_EQ(a, copy);
+    copy.set(5);
+    EXPECT_NE(a, copy);
+    EXPECT_FALSE(a[5]);
+
+    InlineBitTuple<4> moved(move(copy));
+    EXPECT_EQ(3u, moved.count());
+    EXPECT_TRUE(copy.empty());
+
+    InlineBitTuple<4> assigned(10);
+    assigned = a;
+    EXPECT_EQ(a, assigned);
+    assigned = move(moved);
+    EXPECT_EQ(3u, assigned.count());
+    EXPECT_TRUE(assigned[5]);
+
+    assigned.swap(a);
+    EXPECT_EQ(2u, assigned.count());
+    EXPECT_EQ(3u, a.count());
+  }
+
+  // Different sizes are never equal
+  EXPECT_NE(InlineBitTuple<4>(100), InlineBitTuple<4>(101));
+}
+
+TEST(InlineBitTuple, Operators) {
+  for (const std::size_t bits : { 200u, 1000u }) {
+    InlineBitTuple<4> a(bits), b(bits);
+    a.set(1).set(70).set(150);
+    b.set(70).set(150).set(199);
+
+    EXPECT_EQ(2u, (a & b).count());
+    EXPECT_EQ(4u, (a | b).count());
+    EXPECT_EQ(2u, count_and(a, b));
+    EXPECT_EQ(4u, count_or(a, b));
+
+    InlineBitTuple<4> c(a);
+    c ^= b;
+    EXPECT_EQ(2u, c.count());
+    EXPECT_TRUE(c[1]);
+    EXPECT_TRUE(c[199]);
+
+    c -= a;
+    EXPECT_EQ(1u, c.count());
+    EXPECT_TRUE(c[199]);
+
+    const util::BitsetBlocks words = blocks(a);
+    EXPECT_EQ(a.data(), words.data);
+    EXPECT_EQ((bits + 63) / 64, words.size);
+  }
+}
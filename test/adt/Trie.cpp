@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "adt/Trie.h"
+using adt::Trie;
+
+TEST(Trie, Lookup) {
+  const Trie empty;
+  EXPECT_EQ(0u, empty.size());
+  EXPECT_TRUE(empty.has_prefix(""));
+  EXPECT_FALSE(empty.contains(""));
+  EXPECT_FALSE(empty.has_prefix("a"));
+
+  const Trie t(vector<string>{ "ann", "anna", "bob", "ann", "al" });
+  EXPECT_EQ(4u, t.size());
+  // Root, a, an, ann, anna, al, b, bo, bob
+  EXPECT_EQ(9u, t.node_count());
+
+  for (const string word : { "ann", "anna", "bob", "al" })
+    EXPECT_TRUE(t.contains(word)) << word;
+  for (const string word : { "", "a", "an", "annab", "bo", "c" })
+    EXPECT_FALSE(t.contains(word)) << word;
+
+  for (const string prefix : { "", "a", "an", "anna", "b", "bob" })
+    EXPECT_TRUE(t.has_prefix(prefix)) << prefix;
+  for (const string prefix : { "annab", "ab", "c", "bobs" })
+    EXPECT_FALSE(t.has_prefix(prefix)) << prefix;
+
+  // Walking one character at a time
+  Trie::Node n = t.child(t.root(), 'a');
+  n = t.child(n, 'l');
+  EXPECT_TRUE(t.is_word(n));
+  EXPECT_TRUE(t.child(n, 'l') == Trie::npos);
+}
+
+TEST(Trie, ReadWriteView) {
+  const Trie t(vector<string>{ "mississippi", "missouri", "ohio" });
+
+  stringstream file;
+  t.write(file);
+  const string written = file.str();
+
+  Trie loaded;
+  ASSERT_TRUE(loaded.read(file));
+  // Viewing in place, from storage aligned like a mapped file
+  vector<std::uint32_t> aligned(written.size() / 4 + 1);
+  std::copy(written.begin(), written.end(),
+            reinterpret_cast<char *>(aligned.data()));
+  Trie viewed;
+  ASSERT_TRUE(viewed.view(aligned.data(), written.size()));
+
+  // Copies keep working after the original goes away
+  Trie copied;
+  {
+    Trie temporary(loaded);
+    copied = temporary;
+  }
+
+  for (const Trie *c : { &loaded, &viewed, &copied }) {
+    EXPECT_EQ(3u, c->size());
+    EXPECT_EQ(t.node_count(), c->node_count());
+    EXPECT_TRUE(c->contains("missouri"));
+    EXPECT_TRUE(c->has_prefix("missi"));
+    EXPECT_FALSE(c->contains("miss"));
+    EXPECT_FALSE(c->has_prefix("oh no"));
+  }
+
+  // Truncated or foreign data is rejected
+  EXPECT_FALSE(viewed.view(aligned.data(), written.size() - 1));
+  EXPECT_EQ(0u, viewed.size());
+  stringstream truncated(written.substr(0, written.size() - 1));
+  EXPECT_FALSE(loaded.read(truncated));
+  stringstream foreign("not a trie at all");
+  EXPECT_FALSE(loaded.read(foreign));
+
+  // As are nodes or edges pointing outside the trie. The root's first edge
+  // follows the 16 byte header, and the last edge's target ends the file
+  const std::uint32_t outside = 1000000;
+  for (const std::size_t offset :
+       { static_cast<std::size_t>(16), written.size() - 4 }) {
+    string corrupt = written;
+    std::memcpy(&corrupt[offset], &outside, sizeof(outside));
+    stringstream corrupt_file(corrupt);
+    EXPECT_FALSE(loaded.read(corrupt_file));
+    EXPECT_EQ(0u, loaded.size());
+
+    std::copy(corrupt.begin(), corrupt.end(),
+              reinterpret_cast<char *>(aligned.data()));
+    EXPECT_FALSE(viewed.view(aligned.data(), corrupt.size()));
+    EXPECT_EQ(0u, viewed.size());
+  }
+}
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bfeattacks/Accumulator.h"
+#include "bfeattacks/FilterSize.h"
+#include "bfeattacks/SingleRecord.h"
+#include "bloomfilter/BloomFilter.h"
+#include "bloomfilter/HashSet.h"
+#include "graph/Traversals.h"
+#include "hash/HashFactory.h"
+
+TEST(Accumulator, CandidateSetLookup) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  const vector<graph::Traversal> traversals = {
+    { graph::Traversal::all_simple_paths }
+  };
+
+  // The same record counted from its simplified paths and from a candidate
+  // set gives the same stats, as its paths are all distinct
+  bfeattacks::Accumulator from_paths(traversals), from_set(traversals);
+  for (const char *word : { "mississippi", "missouri" }) {
+    bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> scanned(
+        bloomfilter::BloomFilterStandard(256, hs));
+    scanned.insert(word);
+    scanned.construct_graph("abcdefghijklmnopqrstuvwxyz");
+    scanned.setup_traversals(traversals);
+    scanned.run_traversal(graph::Traversal::all_simple_paths);
+    scanned.simplify_paths();
+    from_paths.add(scanned);
+
+    bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> collected(
+        bloomfilter::BloomFilterStandard(256, hs));
+    collected.insert(word);
+    collected.construct_graph("abcdefghijklmnopqrstuvwxyz");
+    collected.setup_traversals(traversals);
+    collected.collect_candidates(graph::Traversal::all_simple_paths);
+    from_set.add(collected);
+  }
+
+  stringstream paths_out, set_out;
+  paths_out << from_paths;
+  set_out << from_set;
+  EXPECT_EQ(paths_out.str(), set_out.str());
+  EXPECT_NE(string::npos, set_out.str().find("correct guess set"));
+}
+
+TEST(Accumulator, EmptyCandidateSet) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  const vector<graph::Traversal> traversals = {
+    { graph::Traversal::all_simple_paths }
+  };
+
+  // A filter leaving no candidates empties the set, which is still looked up
+  // rather than taken for paths that were never simplified
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> scanned(
+      bloomfilter::BloomFilterStandard(256, hs));
+  scanned.insert("mississippi");
+  scanned.construct_graph("abcdefghijklmnopqrstuvwxyz");
+  scanned.setup_traversals(traversals);
+  scanned.run_traversal(graph::Traversal::all_simple_paths);
+  scanned.simplify_paths();
+  bfeattacks::filter_size(scanned, 100, 200);
+  EXPECT_TRUE(
+      scanned.get_simplified_paths(graph::Traversal::all_simple_paths).empty());
+
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> collected(
+      bloomfilter::BloomFilterStandard(256, hs));
+  collected.insert("mississippi");
+  collected.construct_graph("abcdefghijklmnopqrstuvwxyz");
+  collected.setup_traversals(traversals);
+  collected.collect_candidates(graph::Traversal::all_simple_paths);
+  EXPECT_FALSE(
+      collected.get_candidates(graph::Traversal::all_simple_paths).empty());
+  bfeattacks::filter_size(collected, 100, 200);
+  EXPECT_TRUE(collected.is_collected(graph::Traversal::all_simple_paths));
+  EXPECT_TRUE(
+      collected.get_candidates(graph::Traversal::all_simple_paths).empty());
+
+  bfeattacks::Accumulator from_paths(traversals), from_set(traversals);
+  from_paths.add(scanned);
+  from_set.add(collected);
+
+  stringstream paths_out, set_out;
+  paths_out << from_paths;
+  set_out << from_set;
+  EXPECT_EQ(paths_out.str(), set_out.str());
+  EXPECT_NE(string::npos, set_out.str().find("Missed by All Simple Paths\nmississippi"));
+}
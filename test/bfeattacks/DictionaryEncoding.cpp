@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "adt/AdaptiveBitset.h"
+#include "bfeattacks/DictionaryEncoding.h"
+#include "bfeattacks/SingleRecord.h"
+
+#include "bloomfilter/BloomFilter.h"
+#include "bloomfilter/HashSet.h"
+#include "concurrent/ThreadPool.h"
+
+namespace {
+bloomfilter::BloomFilterStandard makeFilter() {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  return bloomfilter::BloomFilterStandard(256, hs);
+}
+}
+
+TEST(DictionaryEncoding, Hex) {
+  boost::dynamic_bitset<> bits(10);
+  bits[0] = bits[5] = bits[9] = true;
+  // 1000 0100 01(00)
+  EXPECT_EQ("844", bfeattacks::filter_to_hex(bits));
+
+  boost::dynamic_bitset<> read;
+  ASSERT_TRUE(bfeattacks::filter_from_hex("844", 10, read));
+  EXPECT_EQ(bits, read);
+  EXPECT_EQ(bfeattacks::fingerprint(bits), bfeattacks::fingerprint(read));
+
+  // Lower case is fine, but not the wrong length or non-hex
+  EXPECT_TRUE(bfeattacks::filter_from_hex("a4c", 10, read));
+  EXPECT_FALSE(bfeattacks::filter_from_hex("8440", 10, read));
+  EXPECT_FALSE(bfeattacks::filter_from_hex("84", 10, read));
+  EXPECT_FALSE(bfeattacks::filter_from_hex("8g4", 10, read));
+
+  bits[1] = true;
+  EXPECT_NE(bfeattacks::fingerprint(bits), bfeattacks::fingerprint(read));
+}
+
+TEST(DictionaryEncoding, HexSparse) {
+  adt::AdaptiveBitset bits(10);
+  bits.set(0).set(5).set(9);
+  EXPECT_EQ("844", bfeattacks::filter_to_hex(bits));
+
+  adt::AdaptiveBitset read;
+  ASSERT_TRUE(bfeattacks::filter_from_hex("844", 10, read));
+  EXPECT_EQ(bits, read);
+  EXPECT_FALSE(bfeattacks::filter_from_hex("8440", 10, read));
+  EXPECT_FALSE(bfeattacks::filter_from_hex("8g4", 10, read));
+
+  // The same digits as a dense filter of the same bits, sparse or not
+  adt::AdaptiveBitset large(100000);
+  boost::dynamic_bitset<> dense(100000);
+  for (const std::size_t p : { 3u, 4096u, 77777u, 99999u }) {
+    large.set(p);
+    dense.set(p);
+  }
+  EXPECT_TRUE(large.is_sparse());
+  EXPECT_EQ(bfeattacks::filter_to_hex(dense), bfeattacks::filter_to_hex(large));
+  ASSERT_TRUE(bfeattacks::filter_from_hex(bfeattacks::filter_to_hex(large),
+                                          100000, read));
+  EXPECT_EQ(large, read);
+}
+
+TEST(DictionaryEncoding, Lookup) {
+  const vector<string> words{ "mississippi", "william", "ramakrishna", "anna",
+                              "bob" };
+  concurrent::ThreadPoolSimple pool(2);
+  // Small blocks so the work is split up
+  bfeattacks::DictionaryEncoding<bloomfilter::BloomFilterStandard> encoding(
+      words, makeFilter, pool, 2);
+  EXPECT_EQ(5u, encoding.size());
+
+  for (const auto &word : words) {
+    bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+        makeFilter());
+    rec.bf.insert(word);
+    encoding.lookup(rec);
+    EXPECT_TRUE(rec.dictionary.ran);
+    EXPECT_EQ(vector<string>{ word }, rec.dictionary.candidates);
+
+    // Through hex like a file of targets would be
+    boost::dynamic_bitset<> bits;
+    ASSERT_TRUE(bfeattacks::filter_from_hex(
+        bfeattacks::filter_to_hex(rec.bf.raw()), 256, bits));
+    EXPECT_EQ(vector<string>{ word }, encoding.lookup(bits));
+  }
+
+  auto other = makeFilter();
+  other.insert("william");
+  other.insert("anna");
+  EXPECT_TRUE(encoding.lookup(other.raw()).empty());
+}
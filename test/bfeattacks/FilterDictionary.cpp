@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "adt/Trie.h"
+#include "bfeattacks/FilterDictionary.h"
+#include "bfeattacks/SingleRecord.h"
+#include "bfeattacks/Streaming.h"
+
+#include "bloomfilter/BloomFilter.h"
+#include "bloomfilter/HashSet.h"
+#include "graph/Traversals.h"
+
+TEST(FilterDictionary, Mississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  const adt::Trie dictionary(
+      vector<string>{ "mipi", "mipissi", "missouri", "ohio" });
+
+  // Count the branches the search goes down with and without the dictionary
+  std::size_t all_branches = 0;
+  bfeattacks::CandidateVisitor count_all;
+  count_all.extend = [&all_branches](const string &) {
+    ++all_branches;
+    return graph::Visit::proceed;
+  };
+  rec.stream_traversal(graph::Traversal::all_simple_paths, count_all);
+
+  std::size_t dictionary_branches = 0;
+  vector<string> streamed;
+  bfeattacks::CandidateVisitor count_dictionary;
+  const auto stage = bfeattacks::filter_dictionary_stage(
+      dictionary, bfeattacks::collect_stage(streamed));
+  count_dictionary.extend = [&dictionary_branches,
+                             &stage](const string &prefix) {
+    ++dictionary_branches;
+    return stage.extend(prefix);
+  };
+  count_dictionary.found = stage.found;
+  rec.stream_traversal(graph::Traversal::all_simple_paths, count_dictionary);
+
+  EXPECT_LT(dictionary_branches, all_branches);
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+  bfeattacks::filter_dictionary(rec, dictionary);
+
+  vector<string> simple_paths{ "mipi", "mipissi" };
+  EXPECT_EQ(simple_paths,
+            rec.get_simplified_paths(graph::Traversal::all_simple_paths));
+  EXPECT_EQ(simple_paths, streamed);
+}
+
+TEST(FilterDictionary, SearchDictionary) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  const adt::Trie dictionary(
+      vector<string>{ "mipi", "mipissi", "missouri", "ohio" });
+
+  bfeattacks::search_dictionary(rec, dictionary);
+  EXPECT_TRUE(rec.pruned.ran);
+  EXPECT_FALSE(rec.pruned.truncated);
+  vector<string> words{ "mipi", "mipissi" };
+  EXPECT_EQ(words, rec.pruned.candidates);
+
+  // The search stops when the budget runs out
+  graph::Budget budget;
+  budget.max_paths = 1;
+  bfeattacks::search_dictionary(rec, dictionary, budget);
+  EXPECT_TRUE(rec.pruned.truncated);
+  EXPECT_GE(1u, rec.pruned.candidates.size());
+}
@@ -198,3 +198,34 @@ TEST(FilterRequireExactly, William) {
   EXPECT_EQ(edge_disjoint, rec.get_simplified_paths(
                                graph::Traversal::all_edge_disjoint_paths));
 }
+
+TEST(FilterRequireExactly, CoveringPaths) {
+  // The covering traversal should find exactly what the filter keeps of all
+  // simple paths, without needing the filter
+  for (const string word : { "mississippi", "ramakrishna", "william" }) {
+    bloomfilter::HashSetPair hs(10);
+    hs.add(hash::MD5).add(hash::SHA3_256);
+    bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+        bloomfilter::BloomFilterStandard(256, hs));
+
+    rec.bf.insert(word);
+    rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+    rec.setup_traversals({ { graph::Traversal::all_simple_paths,
+                             graph::Traversal::all_covering_paths } });
+    rec.run_traversal(graph::Traversal::all_simple_paths);
+    rec.run_traversal(graph::Traversal::all_covering_paths);
+    rec.simplify_paths();
+
+    vector<string> covering =
+        rec.get_simplified_paths(graph::Traversal::all_covering_paths);
+
+    bfeattacks::filter_require_exactly(rec);
+
+    EXPECT_EQ(rec.get_simplified_paths(graph::Traversal::all_simple_paths),
+              covering) << word;
+    EXPECT_EQ(covering,
+              rec.get_simplified_paths(graph::Traversal::all_covering_paths))
+        << word;
+  }
+}
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bfeattacks/Accumulator.h"
+#include "bfeattacks/FilterRequireExactly.h"
+#include "bfeattacks/ParallelAccumulator.h"
+#include "bfeattacks/SingleRecord.h"
+#include "bloomfilter/BloomFilter.h"
+#include "bloomfilter/HashSet.h"
+#include "graph/Traversals.h"
+#include "hash/HashFactory.h"
+
+namespace {
+template <typename BF> string accumulate(const vector<string> &words) {
+  const vector<graph::Traversal> traversals = {
+    { graph::Traversal::all_simple_paths,
+      graph::Traversal::all_covering_paths }
+  };
+
+  auto builder = []() {
+    bloomfilter::HashSetPair hs(10);
+    hs.add(hash::MD5).add(hash::SHA3_256);
+    return bfeattacks::SingleRecord<BF>(BF(100000, hs));
+  };
+  auto filter = [](bfeattacks::SingleRecord<BF> &rec) {
+    bfeattacks::filter_require_exactly(rec);
+  };
+
+  stringstream progress, out;
+  out << bfeattacks::ParallelAccumulate<BF>(
+      words, builder, filter, traversals, "abcdefghijklmnopqrstuvwxyz", 2, 2,
+      progress, 0xFF, 0, graph::Budget(), true, graph::Policy(),
+      { graph::Traversal::all_covering_paths });
+  return out.str();
+}
+}
+
+TEST(ParallelAccumulator, SparseStorage) {
+  // Sparse filters go through the whole pipeline, batching included, and
+  // give the same stats as the standard ones
+  const vector<string> words = { "mississippi", "missouri", "ohio", "anna",
+                                 "bob" };
+  const string sparse = accumulate<bloomfilter::BloomFilterSparse>(words);
+  EXPECT_EQ(accumulate<bloomfilter::BloomFilterStandard>(words), sparse);
+  EXPECT_NE(string::npos, sparse.find("Total trials: 5"));
+}
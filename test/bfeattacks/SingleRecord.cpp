@@ -17,6 +17,7 @@
 //===----------------------------------------------------------------------===//
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 using std::array;
 #include <iostream>
@@ -35,7 +36,9 @@ using std::vector;
 
 #include "bloomfilter/BloomFilter.h"
 #include "bloomfilter/HashSet.h"
+#include "graph/Estimate.h"
 #include "graph/Traversals.h"
+#include "stats/NGramModel.h"
 
 TEST(SingleRecord, NoFiltersMississippi) {
   // Construct the record
@@ -269,3 +272,221 @@ TEST(SingleRecord, NoFiltersWilliam) {
   EXPECT_EQ(edge_disjoint, rec.get_simplified_paths(
                                graph::Traversal::all_edge_disjoint_paths));
 }
+
+TEST(SingleRecord, BudgetMississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  // All simple paths finds 13 paths, so stop after the first 4
+  graph::Budget budget;
+  budget.max_paths = 4;
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths,
+                           graph::Traversal::all_edge_disjoint_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths, budget);
+  rec.run_traversal(graph::Traversal::all_edge_disjoint_paths);
+  rec.simplify_paths();
+
+  EXPECT_TRUE(rec.is_truncated(graph::Traversal::all_simple_paths));
+  EXPECT_FALSE(rec.is_truncated(graph::Traversal::all_edge_disjoint_paths));
+
+  vector<string> simple_paths = { { "mi", "mipi", "mipisi", "mipissi" } };
+  EXPECT_EQ(simple_paths,
+            rec.get_simplified_paths(graph::Traversal::all_simple_paths));
+
+  // Exactly enough budget isn't truncated
+  budget.max_paths = 13;
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths, budget);
+  rec.simplify_paths();
+  EXPECT_FALSE(rec.is_truncated(graph::Traversal::all_simple_paths));
+  EXPECT_EQ(13u,
+            rec.get_simplified_paths(graph::Traversal::all_simple_paths).size());
+}
+
+TEST(SingleRecord, BlockedMississippi) {
+  bloomfilter::HashSetBlocked hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterBlocked> rec(
+      bloomfilter::BloomFilterBlocked(1024, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+
+  // With no false positive bigrams the graph is that of mississippi alone
+  vector<string> simple_paths = {
+    { "mi",   "mipi",   "mipisi",  "mipissi", "mippi",   "mippisi", "mippissi",
+      "misi", "misipi", "misippi", "missi",   "missipi", "missippi" }
+  };
+  EXPECT_EQ(simple_paths,
+            rec.get_simplified_paths(graph::Traversal::all_simple_paths));
+}
+
+TEST(SingleRecord, SparseMississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(100000, hs));
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterSparse> sparse(
+      bloomfilter::BloomFilterSparse(100000, hs));
+
+  rec.bf.insert("mississippi");
+  sparse.bf.insert("mississippi");
+  ASSERT_TRUE(sparse.bf.raw().is_sparse());
+
+  // The sparse filter's graph covers the same bits and gives the same paths
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+  sparse.construct_graph("abcdefghijklmnopqrstuvwxyz");
+  EXPECT_EQ(rec.g[boost::graph_bundle].covers,
+            sparse.g[boost::graph_bundle].covers);
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+  sparse.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  sparse.run_traversal(graph::Traversal::all_simple_paths);
+  sparse.simplify_paths();
+  EXPECT_EQ(13u,
+            sparse.get_simplified_paths(graph::Traversal::all_simple_paths)
+                .size());
+  EXPECT_EQ(rec.get_simplified_paths(graph::Traversal::all_simple_paths),
+            sparse.get_simplified_paths(graph::Traversal::all_simple_paths));
+}
+
+TEST(SingleRecord, CandidatesMississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+  vector<string> expected =
+      rec.get_simplified_paths(graph::Traversal::all_simple_paths);
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+  EXPECT_FALSE(rec.collect_candidates(graph::Traversal::all_simple_paths));
+  vector<string> candidates =
+      rec.get_candidates(graph::Traversal::all_simple_paths).to_vector();
+  std::sort(candidates.begin(), candidates.end());
+  EXPECT_EQ(expected, candidates);
+
+  graph::Budget budget;
+  budget.max_paths = 4;
+  EXPECT_TRUE(
+      rec.collect_candidates(graph::Traversal::all_simple_paths, budget));
+  EXPECT_GE(4u, rec.get_candidates(graph::Traversal::all_simple_paths).size());
+}
+
+TEST(SingleRecord, AdaptiveMississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+  const vector<string> all_paths =
+      rec.get_simplified_paths(graph::Traversal::all_simple_paths);
+
+  // Small enough to search in full, which takes the paths already found
+  rec.run_adaptive();
+  EXPECT_TRUE(rec.adaptive.ran);
+  EXPECT_EQ(graph::Strategy::full, rec.adaptive.plan.strategy);
+  EXPECT_TRUE(rec.adaptive.reused);
+  EXPECT_EQ(all_paths, rec.adaptive.candidates);
+  EXPECT_EQ(0u, rec.adaptive.nodes);
+
+  // Without them it searches itself, giving the same candidates
+  rec.setup_traversals({});
+  rec.run_adaptive();
+  EXPECT_EQ(graph::Strategy::full, rec.adaptive.plan.strategy);
+  EXPECT_FALSE(rec.adaptive.reused);
+  EXPECT_EQ(all_paths, rec.adaptive.candidates);
+  EXPECT_LT(0u, rec.adaptive.nodes);
+
+  // Forbidding a full search falls back to the length bound, which comes from
+  // the estimated number of n-grams so leaves out none of these paths
+  graph::Policy policy;
+  policy.max_full_nodes = 0;
+  policy.max_covering_nodes = 0;
+  rec.run_adaptive(policy);
+  EXPECT_EQ(graph::Strategy::length_bounded, rec.adaptive.plan.strategy);
+  EXPECT_EQ(all_paths, rec.adaptive.candidates);
+
+  // A tight bound keeps only the shortest, Source ^m mi i$ Sink
+  policy.max_length = 4;
+  rec.run_adaptive(policy);
+  EXPECT_EQ(graph::Strategy::length_bounded, rec.adaptive.plan.strategy);
+  vector<string> short_paths = { { "mi" } };
+  EXPECT_EQ(short_paths, rec.adaptive.candidates);
+  EXPECT_FALSE(rec.adaptive.truncated);
+
+  // The search stops when the budget runs out
+  graph::Budget budget;
+  budget.max_paths = 2;
+  rec.run_adaptive(graph::Policy(), budget);
+  EXPECT_TRUE(rec.adaptive.truncated);
+  EXPECT_GE(2u, rec.adaptive.candidates.size());
+}
+
+TEST(SingleRecord, RankedMississippi) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert("mississippi");
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+  rec.run_traversal(graph::Traversal::all_simple_paths);
+  rec.simplify_paths();
+
+  stats::NGramModel model(2, "abcdefghijklmnopqrstuvwxyz");
+  model.add("missouri");
+  model.add("mississauga");
+
+  // Everything, most plausible first
+  rec.run_ranked(model, 0);
+  EXPECT_TRUE(rec.ranked.ran);
+  EXPECT_FALSE(rec.ranked.truncated);
+  vector<string> ranked = rec.ranked.candidates;
+  vector<string> all =
+      rec.get_simplified_paths(graph::Traversal::all_simple_paths);
+  std::sort(ranked.begin(), ranked.end());
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(all, ranked);
+
+  ASSERT_EQ(rec.ranked.candidates.size(), rec.ranked.scores.size());
+  EXPECT_TRUE(std::is_sorted(rec.ranked.scores.rbegin(),
+                             rec.ranked.scores.rend()));
+  for (size_t i = 0; i < rec.ranked.candidates.size(); ++i)
+    EXPECT_DOUBLE_EQ(model.log_probability(rec.ranked.candidates[i]),
+                     rec.ranked.scores[i]);
+
+  // The top few are the same
+  const vector<string> top(rec.ranked.candidates.begin(),
+                           rec.ranked.candidates.begin() + 3);
+  rec.run_ranked(model, 3);
+  EXPECT_FALSE(rec.ranked.truncated);
+  EXPECT_EQ(top, rec.ranked.candidates);
+}
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bfeattacks/FilterRequireExactly.h"
+#include "bfeattacks/FilterSize.h"
+#include "bfeattacks/SingleRecord.h"
+#include "bfeattacks/Streaming.h"
+
+#include "bloomfilter/BloomFilter.h"
+#include "bloomfilter/HashSet.h"
+#include "graph/Traversals.h"
+
+namespace {
+bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard>
+makeRecord(const string &word) {
+  bloomfilter::HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  bfeattacks::SingleRecord<bloomfilter::BloomFilterStandard> rec(
+      bloomfilter::BloomFilterStandard(256, hs));
+
+  rec.bf.insert(word);
+  rec.construct_graph("abcdefghijklmnopqrstuvwxyz");
+
+  return rec;
+}
+}
+
+TEST(Streaming, CollectMatchesStored) {
+  for (const string word : { "mississippi", "ramakrishna", "william" }) {
+    auto rec = makeRecord(word);
+    rec.setup_traversals({ { graph::Traversal::all_simple_paths,
+                             graph::Traversal::all_edge_disjoint_paths } });
+    rec.run_traversal(graph::Traversal::all_simple_paths);
+    rec.run_traversal(graph::Traversal::all_edge_disjoint_paths);
+    rec.simplify_paths();
+
+    for (const auto t : { graph::Traversal::all_simple_paths,
+                          graph::Traversal::all_edge_disjoint_paths }) {
+      vector<string> streamed;
+      EXPECT_FALSE(
+          rec.stream_traversal(t, bfeattacks::collect_stage(streamed)));
+      EXPECT_EQ(rec.get_simplified_paths(t), streamed) << word;
+    }
+  }
+}
+
+TEST(Streaming, FilterStages) {
+  for (const string word : { "mississippi", "ramakrishna", "william" }) {
+    auto rec = makeRecord(word);
+    rec.setup_traversals({ { graph::Traversal::all_simple_paths } });
+    rec.run_traversal(graph::Traversal::all_simple_paths);
+    rec.simplify_paths();
+
+    vector<string> exact;
+    rec.stream_traversal(graph::Traversal::all_simple_paths,
+                         bfeattacks::filter_require_exactly_stage(
+                             rec, bfeattacks::collect_stage(exact)));
+
+    vector<string> sized;
+    rec.stream_traversal(
+        graph::Traversal::all_simple_paths,
+        bfeattacks::filter_size_stage(word.size() - 1, word.size() + 1,
+                                      bfeattacks::collect_stage(sized)));
+
+    bfeattacks::filter_size(rec, word.size() - 1, word.size() + 1);
+    EXPECT_EQ(rec.get_simplified_paths(graph::Traversal::all_simple_paths),
+              sized) << word;
+
+    rec.simplify_paths();
+    bfeattacks::filter_require_exactly(rec);
+    EXPECT_EQ(rec.get_simplified_paths(graph::Traversal::all_simple_paths),
+              exact) << word;
+  }
+}
+
+TEST(Streaming, EarlyStop) {
+  auto rec = makeRecord("mississippi");
+
+  // Stop at the first exact match
+  vector<string> first;
+  EXPECT_TRUE(rec.stream_traversal(
+      graph::Traversal::all_simple_paths,
+      bfeattacks::filter_require_exactly_stage(
+          rec, bfeattacks::limit_stage(1, bfeattacks::collect_stage(first)))));
+  EXPECT_EQ(vector<string>{ "mippissi" }, first);
+
+  // Skipping everything below "mis" leaves just the "mip" candidates
+  vector<string> found;
+  bfeattacks::CandidateVisitor visitor = bfeattacks::collect_stage(found);
+  visitor.extend = [](const string &prefix) {
+    return prefix == "mis" ? graph::Visit::skip : graph::Visit::proceed;
+  };
+  EXPECT_FALSE(
+      rec.stream_traversal(graph::Traversal::all_simple_paths, visitor));
+  vector<string> expected = { "mi",   "mipi",    "mipisi", "mipissi",
+                              "mippi", "mippisi", "mippissi" };
+  EXPECT_EQ(expected, found);
+}
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bloomfilter/BitSamplingIndex.h"
+using bloomfilter::BitSamplingIndex;
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/FilterArray.h"
+using bloomfilter::FilterArray;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "concurrent/ThreadPool.h"
+#include "hash/HashFactory.h"
+
+namespace {
+const vector<string> names{ "smith",  "smyth",  "smithe",   "jones",
+                            "jonas",  "ann",    "anna",     "william",
+                            "willam", "bob",    "robert",   "mississippi" };
+
+bool same_hits(const vector<FilterArray::Hit> &a,
+               const vector<FilterArray::Hit> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i)
+    if (a[i].index != b[i].index || a[i].numerator != b[i].numerator ||
+        a[i].denominator != b[i].denominator)
+      return false;
+  return true;
+}
+}
+
+TEST(BitSamplingIndex, QueryMatchesExactScan) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  vector<BloomFilterStandard> filters;
+  FilterArray array(500);
+  for (const string &name : names) {
+    filters.emplace_back(500, hs);
+    filters.back().insert(name);
+    array.add_filter(filters.back());
+  }
+
+  // Few bits and many tables make near misses almost certain to collide
+  BitSamplingIndex::Parameters parameters;
+  parameters.bits = 4;
+  parameters.tables = 32;
+  concurrent::ThreadPoolSimple pool(2);
+  const BitSamplingIndex index(array, parameters, pool);
+  EXPECT_EQ(names.size(), index.size());
+  EXPECT_DOUBLE_EQ(1.0, index.recall(0));
+  EXPECT_LT(index.recall(100), 1.0);
+  EXPECT_GT(index.recall(100), index.recall(200));
+
+  for (const auto &bf : filters) {
+    vector<FilterArray::Hit> exact, found;
+    array.dice_at_least(bf.raw(), 0.6, exact);
+    const size_t checked = index.query(bf.raw(), 0.6, found);
+    EXPECT_TRUE(same_hits(exact, found));
+    EXPECT_GE(checked, found.size());
+    EXPECT_LE(checked, names.size());
+  }
+
+  // Selective buckets still always find an identical filter
+  parameters.bits = 64;
+  parameters.tables = 2;
+  const BitSamplingIndex strict(array, parameters, pool);
+  for (size_t i = 0; i < filters.size(); ++i) {
+    vector<FilterArray::Hit> found;
+    strict.query(filters[i].raw(), 1.0, found);
+    ASSERT_FALSE(found.empty());
+    EXPECT_EQ(i, found[0].index);
+  }
+}
+
+TEST(BitSamplingIndex, ReadWrite) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  FilterArray array(200);
+  vector<BloomFilterStandard> filters;
+  for (const string &name : names) {
+    filters.emplace_back(200, hs);
+    filters.back().insert(name);
+    array.add_filter(filters.back());
+  }
+
+  concurrent::ThreadPoolSimple pool(2);
+  const BitSamplingIndex index(array, BitSamplingIndex::Parameters(), pool);
+
+  stringstream ss;
+  index.write(ss);
+  BitSamplingIndex read;
+  ASSERT_TRUE(read.read(ss));
+  EXPECT_EQ(index.size(), read.size());
+  EXPECT_EQ(index.parameters().bits, read.parameters().bits);
+  EXPECT_EQ(index.parameters().tables, read.parameters().tables);
+
+  for (const auto &bf : filters) {
+    vector<FilterArray::Hit> expected, found;
+    index.query(bf.raw(), 0.5, expected);
+    read.query(bf.raw(), 0.5, found);
+    EXPECT_TRUE(same_hits(expected, found));
+  }
+
+  stringstream truncated(string("BSI1") + string(10, '\0'));
+  EXPECT_FALSE(read.read(truncated));
+  EXPECT_EQ(0u, read.size());
+
+  // An id past the filters is rejected rather than queried. The first table's
+  // ids follow the magic, the four uint64 parameters, its positions and keys
+  string corrupt = ss.str();
+  const size_t first_id = 4 + 4 * sizeof(std::uint64_t) +
+                          index.parameters().bits * sizeof(std::uint32_t) +
+                          index.size() * sizeof(std::uint64_t);
+  const std::uint32_t outside = static_cast<std::uint32_t>(index.size());
+  std::memcpy(&corrupt[first_id], &outside, sizeof(outside));
+  stringstream corrupt_file(corrupt);
+  EXPECT_FALSE(read.read(corrupt_file));
+  EXPECT_EQ(0u, read.size());
+}
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <cstddef>
+using std::size_t;
+#include <string>
+using std::string;
+using std::to_string;
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bloomfilter/BitSlicedBlock.h"
+using bloomfilter::BitSlicedBlock;
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterSparse;
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "hash/HashFactory.h"
+
+TEST(BitSlicedBlock, AllSet) {
+  BitSlicedBlock block(10, 70);
+  EXPECT_EQ(2u, block.slice_words());
+
+  boost::dynamic_bitset<> bits(10);
+  bits.set(2);
+  bits.set(5);
+  for (size_t r = 0; r < 70; ++r) {
+    // Records 0 and 69 have 2 and 5, the rest only 2
+    if (r == 1)
+      bits.reset(5);
+    if (r == 69)
+      bits.set(5);
+    EXPECT_EQ(r, block.add(bits));
+  }
+
+  util::Word mask[2];
+  EXPECT_TRUE(block.all_set({ 2, 5 }, mask));
+  EXPECT_EQ(util::Word(1), mask[0]);
+  EXPECT_EQ(util::Word(1) << 5, mask[1]);
+
+  EXPECT_TRUE(block.all_set({ 2 }, mask));
+  EXPECT_EQ(~util::Word(0), mask[0]);
+  EXPECT_EQ((util::Word(1) << 6) - 1, mask[1]);
+
+  EXPECT_FALSE(block.all_set({ 2, 3 }, mask));
+}
+
+TEST(BitSlicedBlock, PotentialMembersBatch) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+
+  // More than 64 filters, so records span several words
+  vector<BloomFilterStandard> batched, single;
+  for (size_t i = 0; i < 100; ++i) {
+    const string word = "name" + to_string(i);
+    batched.emplace_back(256, hs);
+    batched.back().insert(word);
+    single.emplace_back(256, hs);
+    single.back().insert(word);
+  }
+
+  vector<const BloomFilterStandard *> filters;
+  for (const auto &bf : batched)
+    filters.push_back(&bf);
+  bloomfilter::potential_members_batch(filters, alphabet);
+
+  for (size_t i = 0; i < batched.size(); ++i) {
+    EXPECT_EQ(single[i].potential_members(alphabet),
+              batched[i].potential_members(alphabet))
+        << i;
+    EXPECT_EQ(single[i].false_members(), batched[i].false_members()) << i;
+  }
+}
+
+TEST(BitSlicedBlock, PotentialMembersBatchSparse) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+
+  // Sparse storage has no words, so is sliced from its positions
+  vector<BloomFilterSparse> batched;
+  vector<BloomFilterStandard> standard;
+  for (size_t i = 0; i < 100; ++i) {
+    const string word = "name" + to_string(i);
+    batched.emplace_back(100000, hs);
+    batched.back().insert(word);
+    standard.emplace_back(100000, hs);
+    standard.back().insert(word);
+  }
+  ASSERT_TRUE(batched.front().raw().is_sparse());
+
+  vector<const BloomFilterSparse *> filters;
+  for (const auto &bf : batched)
+    filters.push_back(&bf);
+  bloomfilter::potential_members_batch(filters, alphabet);
+
+  for (size_t i = 0; i < batched.size(); ++i)
+    EXPECT_EQ(standard[i].potential_members(alphabet),
+              batched[i].potential_members(alphabet))
+        << i;
+}
@@ -17,6 +17,8 @@
 //===----------------------------------------------------------------------===//
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 using std::cout;
 using std::endl;
@@ -33,14 +35,21 @@ using std::vector;
 
 #include "bloomfilter/BloomFilter.h"
 using bloomfilter::BloomFilter;
+using bloomfilter::BloomFilterAligned;
+using bloomfilter::BloomFilterBlocked;
+using bloomfilter::BloomFilterInline;
+using bloomfilter::BloomFilterSparse;
 using bloomfilter::BloomFilterStandard;
+using bloomfilter::FixedBloomFilter;
 #include "bloomfilter/HashSet.h"
 using bloomfilter::HashSetSimple;
 using bloomfilter::HashSetPair;
+using bloomfilter::HashSetBlocked;
 #include "bloomfilter/InsertionPolicy.h"
 using bloomfilter::InsertionBigramWithSentinel;
 using bloomfilter::InsertionTrigramWithSentinel;
 #include "hash/HashFactory.h"
+#include "util/BitsetBlocks.h"
 #include "util/ByteVector.h"
 using util::ByteVector::toByteVector;
 
@@ -346,6 +355,10 @@ TEST(BloomFilter, DiceCoefficient) {
 
   EXPECT_EQ(dice.first, 10);
   EXPECT_EQ(dice.second, 13);
+
+  dice_coeff jaccard = bloomfilter::jaccard_coefficient(bf1, bf2);
+  EXPECT_EQ(jaccard.first, 5);
+  EXPECT_EQ(jaccard.second, 8);
 }
 
 TEST(BloomFilter, TREncodingExample) {
@@ -448,3 +461,257 @@ TEST(BloomFilter, TREncodingExample) {
   ss2 << filter;
   EXPECT_EQ(contents2, ss2.str());
 }
+
+TEST(BloomFilter, Lightweight) {
+  typedef BloomFilter<HashSetPair, InsertionBigramWithSentinel, false>
+      Untracked;
+
+  // Just the hashes, bits and length, plus one pointer for everything else
+  EXPECT_LE(sizeof(Untracked),
+            sizeof(HashSetPair) + sizeof(boost::dynamic_bitset<>) +
+                sizeof(unsigned int) + sizeof(void *) + 8);
+
+  HashSetPair hs(2);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  Untracked plain(20, hs);
+  plain.insert("test");
+  EXPECT_TRUE(plain.actual_inserted().empty());
+  EXPECT_TRUE(plain.true_members().empty());
+
+  BloomFilterStandard tracked(20, hs);
+  tracked.insert("test");
+  tracked.potential_members("est");
+
+  // Copies carry what was tracked, independently of the original
+  BloomFilterStandard copy(tracked);
+  EXPECT_EQ(tracked.raw(), copy.raw());
+  EXPECT_EQ(tracked.true_members(), copy.true_members());
+  EXPECT_EQ(tracked.potential_members("est"), copy.potential_members("est"));
+  EXPECT_EQ(tracked.false_members(), copy.false_members());
+
+  copy.insert("set");
+  EXPECT_EQ(1u, tracked.actual_inserted().size());
+  EXPECT_EQ(2u, copy.actual_inserted().size());
+
+  BloomFilterStandard moved(std::move(copy));
+  EXPECT_EQ(2u, moved.actual_inserted().size());
+}
+
+TEST(BloomFilter, AlignedStorage) {
+  HashSetPair hs(2);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  BloomFilterStandard a(1000, hs), b(1000, hs);
+  BloomFilterAligned a_aligned(1000, hs), b_aligned(1000, hs);
+  a.insert("mississippi");
+  a_aligned.insert("mississippi");
+  b.insert("missouri");
+  b_aligned.insert("missouri");
+
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(a_aligned.words().data) % 64);
+  EXPECT_EQ(0u, a_aligned.words().size % 8);
+
+  // The same bits, with the aligned words zero padded past the default's
+  const util::BitsetBlocks words = a.words();
+  const util::BitsetBlocks aligned = a_aligned.words();
+  ASSERT_GE(aligned.size, words.size);
+  for (std::size_t i = 0; i < aligned.size; ++i)
+    EXPECT_EQ(i < words.size ? words.data[i] : 0u, aligned.data[i]);
+
+  EXPECT_EQ(a.count(), a_aligned.count());
+  EXPECT_EQ(dice_coefficient(a, b), dice_coefficient(a_aligned, b_aligned));
+  EXPECT_EQ(jaccard_coefficient(a, b),
+            jaccard_coefficient(a_aligned, b_aligned));
+
+  EXPECT_TRUE(a_aligned.contains("mississippi"));
+  EXPECT_TRUE(a_aligned.contains_exactly("mississippi"));
+  EXPECT_FALSE(a_aligned.contains_exactly("missouri"));
+  EXPECT_EQ(a.potential_members("imps"), a_aligned.potential_members("imps"));
+}
+
+TEST(BloomFilter, InlineStorage) {
+  HashSetPair hs(2);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  BloomFilterStandard a(1000, hs), b(1000, hs);
+  BloomFilterInline a_inline(1000, hs), b_inline(1000, hs);
+  a.insert("mississippi");
+  a_inline.insert("mississippi");
+  b.insert("missouri");
+  b_inline.insert("missouri");
+
+  EXPECT_TRUE(a_inline.raw().isInline());
+
+  const util::BitsetBlocks words = a.words();
+  const util::BitsetBlocks inlined = a_inline.words();
+  ASSERT_EQ(words.size, inlined.size);
+  for (std::size_t i = 0; i < words.size; ++i)
+    EXPECT_EQ(words.data[i], inlined.data[i]);
+
+  EXPECT_EQ(dice_coefficient(a, b), dice_coefficient(a_inline, b_inline));
+  EXPECT_TRUE(a_inline.contains_exactly("mississippi"));
+  EXPECT_EQ(a.potential_members("imps"), a_inline.potential_members("imps"));
+
+  BloomFilterInline copy(a_inline);
+  EXPECT_EQ(a_inline.raw(), copy.raw());
+}
+
+TEST(BloomFilter, FixedSize) {
+  const auto key1 = toByteVector("1111111111111111111111111111111111111111111111111111111111111111");
+  const auto key2 = toByteVector("2222222222222222222222222222222222222222222222222222222222222222");
+
+  HashSetPair hs(30);
+  hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+  bloomfilter::HashSetPairFixed<1000, 30> fixed_hs(30);
+  fixed_hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+
+  BloomFilterStandard a(1000, hs), b(1000, hs);
+  FixedBloomFilter<1000, 30> a_fixed(1000, fixed_hs), b_fixed(1000, fixed_hs);
+  a.insert("mississippi");
+  a_fixed.insert("mississippi");
+  b.insert("missouri");
+  b_fixed.insert("missouri");
+
+  // The same positions, so the same bits
+  EXPECT_EQ(a.member_positions("is"), a_fixed.member_positions("is"));
+  const util::BitsetBlocks words = a.words();
+  const util::BitsetBlocks fixed = a_fixed.words();
+  ASSERT_EQ(words.size, fixed.size);
+  for (std::size_t i = 0; i < words.size; ++i)
+    EXPECT_EQ(words.data[i], fixed.data[i]);
+  EXPECT_EQ(a.raw(), util::as_dynamic_bitset(a_fixed.raw()));
+
+  EXPECT_EQ(dice_coefficient(a, b), dice_coefficient(a_fixed, b_fixed));
+  EXPECT_TRUE(a_fixed.contains_exactly("mississippi"));
+  EXPECT_EQ(a.potential_members("imps"), a_fixed.potential_members("imps"));
+
+  // A small setup too, where m is not a whole number of words
+  HashSetPair small_hs(6);
+  small_hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+  bloomfilter::HashSetPairFixed<200, 6> small_fixed_hs(6);
+  small_fixed_hs.addHMAC(hash::SHA_256, key1).addHMAC(hash::SHA_256, key2);
+
+  BloomFilterStandard small(200, small_hs);
+  FixedBloomFilter<200, 6> small_fixed(200, small_fixed_hs);
+  small.insert("mississippi");
+  small_fixed.insert("mississippi");
+  EXPECT_EQ(small.raw(), util::as_dynamic_bitset(small_fixed.raw()));
+  EXPECT_EQ(small.count(), small_fixed.count());
+}
+
+TEST(BloomFilter, SparseStorage) {
+  HashSetPair hs(20);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  BloomFilterStandard a(100000, hs), b(100000, hs);
+  BloomFilterSparse a_sparse(100000, hs), b_sparse(100000, hs);
+  a.insert("mississippi");
+  a_sparse.insert("mississippi");
+  b.insert("missouri");
+  b_sparse.insert("missouri");
+
+  EXPECT_TRUE(a_sparse.raw().is_sparse());
+  EXPECT_EQ(a.count(), a_sparse.count());
+  a_sparse.raw().for_each_set(
+      [&a](std::size_t p) { EXPECT_TRUE(a.raw()[p]); });
+
+  EXPECT_EQ(dice_coefficient(a, b), dice_coefficient(a_sparse, b_sparse));
+  EXPECT_EQ(jaccard_coefficient(a, b),
+            jaccard_coefficient(a_sparse, b_sparse));
+  EXPECT_TRUE(a_sparse.contains("mississippi"));
+  EXPECT_TRUE(a_sparse.contains_exactly("mississippi"));
+  EXPECT_FALSE(a_sparse.contains_exactly("missouri"));
+  EXPECT_EQ(a.potential_members("imps"), a_sparse.potential_members("imps"));
+}
+
+TEST(BloomFilter, Blocked) {
+  HashSetBlocked hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  BloomFilterBlocked bf(2048, hs);
+  bf.insert("mississippi");
+
+  EXPECT_TRUE(bf.contains("mississippi"));
+  EXPECT_TRUE(bf.contains("mississippississippi"));
+  EXPECT_TRUE(bf.contains_exactly("mississippi"));
+  EXPECT_FALSE(bf.contains_exactly("missouri"));
+  EXPECT_FALSE(bf.contains("missouri"));
+
+  // Each bigram sets bits in only one of the four blocks
+  for (const char *bigram :
+       { "^m", "mi", "is", "ss", "si", "ip", "pp", "pi", "i$" }) {
+    set<unsigned int> blocks;
+    for (unsigned int position : bf.member_positions(bigram)) {
+      EXPECT_TRUE(bf.raw()[position]);
+      blocks.insert(position / 512);
+    }
+    EXPECT_EQ(1u, blocks.size());
+  }
+  // ... and each block is one cache line
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(bf.words().data) % 64);
+}
+
+TEST(BloomFilter, IncrementalMembers) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+  BloomFilterStandard bf(256, hs);
+  BloomFilter<HashSetPair, InsertionBigramWithSentinel, false> untracked(256,
+                                                                         hs);
+  bf.potential_members(alphabet);
+  bf.false_members();
+  untracked.potential_members(alphabet);
+
+  // After each insert the members kept up to date match those found afresh,
+  // including bg going from a false positive to a real member
+  vector<string> inserted;
+  for (const char *in : { "test", "foo", "bg", "mississippi", "test" }) {
+    bf.insert(in);
+    untracked.insert(in);
+    inserted.push_back(in);
+
+    BloomFilterStandard fresh(256, hs);
+    for (const string &s : inserted)
+      fresh.insert(s);
+
+    EXPECT_EQ(fresh.raw(), bf.raw());
+    EXPECT_EQ(fresh.potential_members(alphabet), bf.potential_members(alphabet));
+    EXPECT_EQ(fresh.false_members(), bf.false_members());
+    EXPECT_EQ(fresh.potential_members(alphabet),
+              untracked.potential_members(alphabet));
+  }
+
+  // Seeded members can't be updated, so are found again after an insert
+  BloomFilterStandard seeded(256, hs);
+  seeded.seed_potential_members(alphabet, { "xx" });
+  seeded.insert("foo");
+  BloomFilterStandard fresh(256, hs);
+  fresh.insert("foo");
+  EXPECT_EQ(fresh.potential_members(alphabet),
+            seeded.potential_members(alphabet));
+}
+
+TEST(BloomFilter, CopyAssign) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  const string alphabet = "abcdefghijklmnopqrstuvwxyz";
+  BloomFilterStandard a(256, hs), b(128, hs);
+  a.insert("mississippi");
+  const vector<string> members = a.potential_members(alphabet);
+  b.insert("foo");
+
+  b = a;
+  EXPECT_EQ(a.length(), b.length());
+  EXPECT_EQ(a.raw(), b.raw());
+  EXPECT_EQ(members, b.potential_members(alphabet));
+
+  // The copy is deep, so inserting into one leaves the other alone
+  b.insert("missouri");
+  EXPECT_NE(a.raw(), b.raw());
+  EXPECT_EQ(members, a.potential_members(alphabet));
+  EXPECT_FALSE(a.contains("missouri"));
+  EXPECT_TRUE(b.contains("missouri"));
+}
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/ExactMatcher.h"
+using bloomfilter::ExactMatcher;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "hash/HashFactory.h"
+
+TEST(ExactMatcher, AgreesWithContainsExactly) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  // A small filter, so some candidates are false positives of contains
+  for (const unsigned int m : { 64u, 256u, 1000u }) {
+    BloomFilterStandard bf(m, hs);
+    bf.insert("mississippi");
+
+    ExactMatcher<BloomFilterStandard> matcher(bf);
+    // Repeated and overlapping candidates exercise the memo and scratch reset
+    for (const string candidate :
+         { "mississippi", "mipi", "missippi", "mississippi", "", "m",
+           "mississippis", "sip", "mississippi", "mipissi" })
+      EXPECT_EQ(bf.contains_exactly(candidate), matcher.matches(candidate))
+          << m << " " << candidate;
+  }
+}
+
+TEST(ExactMatcher, RetainMatches) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  BloomFilterStandard bf(1000, hs);
+  bf.insert("mississippi");
+
+  ExactMatcher<BloomFilterStandard> matcher(bf);
+  vector<string> candidates{ "mipi", "mississippi", "mipissi", "mississippi" };
+  matcher.retain_matches(candidates);
+
+  vector<string> expected{ "mississippi", "mississippi" };
+  EXPECT_EQ(expected, candidates);
+  // ^m mi ip pi i$ is ss si pp
+  EXPECT_EQ(9u, matcher.memo_size());
+
+  // An empty filter is only matched by candidates setting no bits
+  BloomFilterStandard empty(1000, hs);
+  ExactMatcher<BloomFilterStandard> empty_matcher(empty);
+  EXPECT_EQ(empty.contains_exactly(""), empty_matcher.matches(""));
+  EXPECT_FALSE(empty_matcher.matches("a"));
+}
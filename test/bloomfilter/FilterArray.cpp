@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/FilterArray.h"
+using bloomfilter::FilterArray;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "hash/HashFactory.h"
+#include "util/BitKernels.h"
+
+TEST(FilterArray, MatchesDiceCoefficient) {
+  HashSetPair hs(15);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  const unsigned int m = 1000;
+  const vector<string> names{ "smith", "smyth", "smithe", "jones" };
+  vector<BloomFilterStandard> filters;
+  FilterArray array(m);
+  for (const string &name : names) {
+    filters.emplace_back(m, hs);
+    filters.back().insert(name);
+    EXPECT_EQ(filters.size() - 1, array.add_filter(filters.back()));
+  }
+  const boost::dynamic_bitset<> empty(m);
+  EXPECT_EQ(names.size(), array.add(empty));
+  array.add(empty);
+  EXPECT_EQ(names.size() + 2, array.size());
+
+  vector<FilterArray::Ratio> all;
+  array.dice_all(filters[0].raw(), all);
+  ASSERT_EQ(names.size() + 2, all.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto expected = bloomfilter::dice_coefficient(filters[0], filters[i]);
+    EXPECT_EQ(expected.first, all[i].first) << i;
+    EXPECT_EQ(expected.second, all[i].second) << i;
+    EXPECT_EQ(all[i], array.dice(filters[0].raw(), i)) << i;
+    EXPECT_EQ(filters[i].count(), array.count(i));
+  }
+  EXPECT_EQ(all[0].first, all[0].second);
+
+  // Only smith itself and the similar spellings come close
+  vector<FilterArray::Hit> hits;
+  array.dice_at_least(filters[0].raw(), 0.5, hits);
+  ASSERT_EQ(3u, hits.size());
+  EXPECT_EQ(0u, hits[0].index);
+  EXPECT_EQ(1u, hits[1].index);
+  EXPECT_EQ(2u, hits[2].index);
+  for (const FilterArray::Hit &hit : hits) {
+    EXPECT_EQ(all[hit.index].first, hit.numerator);
+    EXPECT_EQ(all[hit.index].second, hit.denominator);
+  }
+
+  // Empty filters against each other have no coefficient
+  hits.clear();
+  array.dice_at_least(empty, 0.0, hits);
+  EXPECT_EQ(names.size(), hits.size());
+}
+
+TEST(FilterArray, ReadWrite) {
+  HashSetPair hs(15);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  FilterArray array(100);
+  for (const string name : { "smith", "jones", "" }) {
+    BloomFilterStandard bf(100, hs);
+    bf.insert(name);
+    array.add_filter(bf);
+  }
+
+  stringstream ss;
+  array.write(ss);
+  FilterArray read(1);
+  ASSERT_TRUE(read.read(ss));
+  EXPECT_EQ(array.length(), read.length());
+  ASSERT_EQ(array.size(), read.size());
+  for (size_t i = 0; i < array.size(); ++i) {
+    EXPECT_EQ(array.count(i), read.count(i));
+    for (size_t w = 0; w < array.row_words(); ++w)
+      EXPECT_EQ(array.row(i)[w], read.row(i)[w]);
+  }
+
+  stringstream bad("FAR0");
+  EXPECT_FALSE(read.read(bad));
+  EXPECT_EQ(0u, read.size());
+
+  // A header claiming far more filters than follow fails as it runs out,
+  // without allocating them all first
+  const std::uint64_t huge[] = { 100, static_cast<std::uint64_t>(1) << 40 };
+  string claimed = "FAR1";
+  claimed.append(reinterpret_cast<const char *>(huge), sizeof(huge));
+  stringstream short_file(claimed);
+  EXPECT_FALSE(read.read(short_file));
+  EXPECT_EQ(0u, read.size());
+
+  // Bits set past m are rejected. The first row's second word holds bits 64
+  // to 127, so its top bit is past m = 100
+  string padded = ss.str();
+  padded[4 + sizeof(huge) + 2 * sizeof(util::Word) - 1] = '\x80';
+  stringstream padded_file(padded);
+  EXPECT_FALSE(read.read(padded_file));
+}
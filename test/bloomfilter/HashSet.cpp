@@ -17,6 +17,7 @@
 //===----------------------------------------------------------------------===//
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <sstream>
 using std::stringstream;
 #include <string>
@@ -27,6 +28,7 @@ using std::vector;
 #include "bloomfilter/HashSet.h"
 using bloomfilter::HashSetSimple;
 using bloomfilter::HashSetPair;
+using bloomfilter::HashSetBlocked;
 #include "hash/HashFactory.h"
 #include "util/ByteVector.h"
 using util::ByteVector::toByteVector;
@@ -137,3 +139,34 @@ TEST(HashSet, Pair) {
   ++i;
   EXPECT_EQ(p.end(), i);
 }
+
+TEST(HashSet, Blocked) {
+  HashSetBlocked hs(12);
+
+  hs.add(hash::MD5).add(hash::SHA3_256);
+
+  stringstream ss;
+  ss << hs;
+  EXPECT_EQ("Blocked (k = 12) {MD5, SHA3-256}", ss.str());
+
+  // 1000 bits is one full block and one of 488, and 1023 bits one full and
+  // one of 511. Every input's positions share a block and are distinct, in
+  // the short blocks too
+  for (unsigned int m : { 1000u, 1023u, 12u, 13u }) {
+    for (const char *in : { "", "^m", "mi", "is", "ss", "si", "ip", "pp", "pi",
+                            "i$", "abc", "xyz" }) {
+      HashSetBlocked::processor p = hs.process(in, m);
+      vector<unsigned int> positions(p.begin(), p.end());
+      ASSERT_EQ(12u, positions.size());
+      unsigned int block = positions[0] / 512;
+      for (unsigned int position : positions) {
+        EXPECT_GT(m, position);
+        EXPECT_EQ(block, position / 512);
+      }
+      std::sort(positions.begin(), positions.end());
+      EXPECT_EQ(positions.end(),
+                std::adjacent_find(positions.begin(), positions.end()))
+          << "m = " << m << ", in = " << in;
+    }
+  }
+}
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint32_t;
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "bloomfilter/BloomFilter.h"
+using bloomfilter::BloomFilterStandard;
+#include "bloomfilter/FilterArray.h"
+using bloomfilter::FilterArray;
+#include "bloomfilter/HashSet.h"
+using bloomfilter::HashSetPair;
+#include "bloomfilter/SimilarityJoin.h"
+using bloomfilter::JoinOptions;
+using bloomfilter::JoinPair;
+#include "concurrent/ThreadPool.h"
+#include "hash/HashFactory.h"
+
+namespace {
+const vector<string> left_names{ "smith", "jones", "william", "ann",
+                                 "mississippi", "smyth", "" };
+const vector<string> right_names{ "smithe", "jonas", "williams", "anna",
+                                  "smith", "missisippi", "bob", "willam" };
+
+vector<BloomFilterStandard> encode(const vector<string> &names,
+                                   HashSetPair &hs) {
+  vector<BloomFilterStandard> filters;
+  for (const string &name : names) {
+    filters.emplace_back(500, hs);
+    filters.back().insert(name);
+  }
+  return filters;
+}
+
+FilterArray pack(const vector<BloomFilterStandard> &filters) {
+  FilterArray array(500);
+  for (const auto &bf : filters)
+    array.add_filter(bf);
+  return array;
+}
+
+// Every pair at or above threshold, compared one at a time, in join order
+vector<JoinPair> brute_force(const vector<BloomFilterStandard> &left,
+                             const vector<BloomFilterStandard> &right,
+                             double threshold, size_t top_k) {
+  vector<JoinPair> all;
+  for (size_t i = 0; i < left.size(); ++i) {
+    vector<JoinPair> pairs;
+    for (size_t j = 0; j < right.size(); ++j) {
+      const auto dice = bloomfilter::dice_coefficient(left[i], right[j]);
+      if (dice.second != 0 && static_cast<double>(dice.first) >=
+                                  threshold * static_cast<double>(dice.second))
+        pairs.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(j),
+                          static_cast<uint32_t>(dice.first),
+                          static_cast<uint32_t>(dice.second) });
+    }
+
+    if (top_k != 0) {
+      std::stable_sort(pairs.begin(), pairs.end(),
+                       [](const JoinPair &a, const JoinPair &b) {
+                         return a.dice() > b.dice();
+                       });
+      pairs.resize(std::min(top_k, pairs.size()));
+    }
+    all.insert(all.end(), pairs.begin(), pairs.end());
+  }
+  return all;
+}
+}
+
+TEST(SimilarityJoin, MatchesBruteForce) {
+  HashSetPair hs(10);
+  hs.add(hash::MD5).add(hash::SHA3_256);
+  const auto left = encode(left_names, hs);
+  const auto right = encode(right_names, hs);
+  const FilterArray left_array = pack(left), right_array = pack(right);
+
+  concurrent::ThreadPoolSimple pool(2);
+  for (const double threshold : { 0.0, 0.5, 0.8, 1.0 })
+    for (const size_t top_k : { 0u, 1u, 3u })
+      // Small blocks so several tiles and tasks are involved
+      for (const size_t block_rows : { 2u, 256u }) {
+        JoinOptions options;
+        options.threshold = threshold;
+        options.top_k = top_k;
+        options.block_rows = block_rows;
+
+        EXPECT_EQ(brute_force(left, right, threshold, top_k),
+                  bloomfilter::dice_join(left_array, right_array, options,
+                                         pool))
+            << threshold << " " << top_k << " " << block_rows;
+      }
+
+  // Only names with the same bigrams match exactly
+  JoinOptions exact;
+  exact.threshold = 1.0;
+  const vector<JoinPair> same =
+      bloomfilter::dice_join(left_array, right_array, exact, pool);
+  ASSERT_EQ(2u, same.size());
+  EXPECT_EQ(0u, same[0].left);
+  EXPECT_EQ(4u, same[0].right);
+  EXPECT_EQ(4u, same[1].left);
+  EXPECT_EQ(5u, same[1].right);
+}
+
+TEST(SimilarityJoin, ReadWrite) {
+  const vector<JoinPair> pairs{ { 0, 4, 20, 20 }, { 3, 1, 7, 12 } };
+
+  stringstream ss;
+  bloomfilter::write_join_header(ss);
+  bloomfilter::write_join_pairs(ss, pairs);
+
+  vector<JoinPair> read;
+  EXPECT_TRUE(bloomfilter::read_join(ss, read));
+  EXPECT_EQ(pairs, read);
+
+  stringstream bad("DJN0");
+  EXPECT_FALSE(bloomfilter::read_join(bad, read));
+  stringstream partial("DJN1abc");
+  EXPECT_FALSE(bloomfilter::read_join(partial, read));
+}
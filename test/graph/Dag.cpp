@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <array>
+using std::array;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "graph/Dag.h"
+#include "graph/Graph.h"
+using graph::Graph_t;
+#include "graph/Traversals.h"
+
+TEST(Dag, CountAndEnumerate) {
+  // a is the source and b the sink. f is a dead end off of c, and a has two
+  // parallel edges to d, each giving its own paths
+  Graph_t g(6);
+
+  for (unsigned char i = 0; i < 6; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  array<array<unsigned, 2>, 9> edges{
+    { { { 0, 2 } }, { { 0, 3 } }, { { 2, 3 } }, { { 2, 1 } }, { { 3, 4 } },
+      { { 4, 1 } }, { { 3, 1 } }, { { 2, 5 } }, { { 0, 3 } } }
+  };
+
+  size_t edge_index = 0;
+  for (const auto &i : edges)
+    boost::add_edge(i[0], i[1], edge_index++, g);
+
+  EXPECT_TRUE(graph::is_acyclic(g));
+  EXPECT_EQ(7u, graph::count_dag_paths(g, 0, 1));
+  EXPECT_EQ(3u, graph::count_dag_paths(g, 2, 1));
+  EXPECT_EQ(0u, graph::count_dag_paths(g, 5, 1));
+
+  vector<vector<string> > paths;
+  graph::run_traversal(g, 0, 1, paths, graph::Traversal::all_simple_paths);
+
+  vector<vector<string> > expected_paths{
+    { { { "a", "c", "d", "e", "b" } }, { { "a", "c", "d", "b" } },
+      { { "a", "c", "b" } }, { { "a", "d", "e", "b" } }, { { "a", "d", "b" } },
+      { { "a", "d", "e", "b" } }, { { "a", "d", "b" } } }
+  };
+  EXPECT_EQ(expected_paths, paths);
+
+  // Closing a cycle falls back to the usual search, which finds the same paths
+  // plus those through the new edge
+  boost::add_edge(4, 2, edge_index++, g);
+  EXPECT_FALSE(graph::is_acyclic(g));
+  EXPECT_EQ(0u, graph::count_dag_paths(g, 0, 1));
+
+  paths.clear();
+  graph::run_traversal(g, 0, 1, paths, graph::Traversal::all_simple_paths);
+  EXPECT_EQ(9u, paths.size());
+}
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "graph/Estimate.h"
+#include "graph/Graph.h"
+using graph::Graph_t;
+using graph::Vertex_t;
+#include "graph/Traversals.h"
+
+namespace {
+// Source a, sink b and every edge among c through g in both directions. Every
+// walk of the same length has the same choices, so the estimate is exact
+Graph_t make_complete() {
+  Graph_t g(7);
+
+  for (unsigned char i = 0; i < 7; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  size_t edge_index = 0;
+  for (unsigned i = 2; i < 7; ++i) {
+    boost::add_edge(0, i, edge_index++, g);
+    boost::add_edge(i, 1, edge_index++, g);
+    for (unsigned j = 2; j < 7; ++j)
+      if (i != j)
+        boost::add_edge(i, j, edge_index++, g);
+  }
+  boost::add_edge(0, 1, edge_index++, g);
+
+  return g;
+}
+}
+
+TEST(Estimate, Complete) {
+  Graph_t g = make_complete();
+
+  // 1 + 5 + 5*4 + 5*4*3 + 5*4*3*2 + 5! paths, and the same number of vertices
+  // discovered other than the sink
+  graph::Estimate full = graph::estimate_simple_paths(g, 0, 1, 8);
+  EXPECT_DOUBLE_EQ(326, full.paths);
+  EXPECT_DOUBLE_EQ(326, full.nodes);
+
+  // Only paths of up to 3 edges, while the search discovers the vertices
+  // ending 3 edges out before stopping
+  graph::Estimate bounded = graph::estimate_simple_paths(g, 0, 1, 8, 3);
+  EXPECT_DOUBLE_EQ(1 + 5 + 5 * 4, bounded.paths);
+  EXPECT_DOUBLE_EQ(1 + 5 + 5 * 4 + 5 * 4 * 3, bounded.nodes);
+
+  // Which the search agrees with
+  size_t nodes = 0;
+  size_t paths = 0;
+  graph::PathVisitor visitor;
+  visitor.extend = [&nodes](const vector<Vertex_t> &branch) {
+    ++nodes;
+    return branch.size() > 3 ? graph::Visit::skip : graph::Visit::proceed;
+  };
+  visitor.found = [&paths](const vector<Vertex_t> &) {
+    ++paths;
+    return graph::Visit::proceed;
+  };
+  graph::run_traversal(g, 0, 1, visitor, graph::Traversal::all_simple_paths);
+  EXPECT_EQ(86u, nodes);
+  EXPECT_EQ(26u, paths);
+}
+
+TEST(Estimate, Plan) {
+  Graph_t g = make_complete();
+
+  graph::Policy policy;
+  policy.max_full_nodes = 1000;
+  EXPECT_EQ(graph::Strategy::full,
+            graph::plan_traversal(g, 0, 1, policy).strategy);
+
+  // Without covers there is no covering search, and no length bound skips
+  // straight to counting
+  policy.max_full_nodes = 100;
+  policy.max_covering_nodes = 1000;
+  graph::Plan plan = graph::plan_traversal(g, 0, 1, policy);
+  EXPECT_EQ(graph::Strategy::count_only, plan.strategy);
+  EXPECT_DOUBLE_EQ(326, plan.estimate.paths);
+
+  policy.max_length = 3;
+  policy.max_bounded_nodes = 100;
+  plan = graph::plan_traversal(g, 0, 1, policy);
+  EXPECT_EQ(graph::Strategy::length_bounded, plan.strategy);
+  EXPECT_DOUBLE_EQ(86, plan.estimate.nodes);
+
+  policy.max_bounded_nodes = 50;
+  EXPECT_EQ(graph::Strategy::count_only,
+            graph::plan_traversal(g, 0, 1, policy).strategy);
+
+  g[boost::graph_bundle].covers.resize(1, true);
+  EXPECT_EQ(graph::Strategy::covering,
+            graph::plan_traversal(g, 0, 1, policy).strategy);
+}
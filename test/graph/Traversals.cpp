@@ -17,6 +17,7 @@
 //===----------------------------------------------------------------------===//
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 using std::array;
 #include <iostream>
@@ -29,6 +30,7 @@ using std::pair;
 #include <vector>
 using std::vector;
 
+#include "concurrent/ThreadPool.h"
 #include "graph/Graph.h"
 using graph::Graph_t;
 #include "graph/Traversals.h"
@@ -91,3 +93,302 @@ TEST(Traversal, P4C4Intersection) {
   };
   EXPECT_EQ(expected_edge_disjoint_paths, all_edge_disjoint_paths);
 }
+
+TEST(Traversal, P4C4Covering) {
+  // Same graph as P4C4Intersection, but each vertex covers some bits and only
+  // paths covering all of them should be found
+  Graph_t g(6);
+
+  for (unsigned char i = 0; i < 6; ++i) {
+    g[i].name = string({ static_cast<char>('a' + i) });
+    g[i].covers.resize(3);
+  }
+  g[boost::graph_bundle].covers.resize(3);
+  g[boost::graph_bundle].covers.set();
+
+  g[2].covers.set(0);
+  g[3].covers.set(1);
+  g[5].covers.set(1);
+  g[4].covers.set(2);
+
+  array<array<unsigned, 2>, 8> edges{
+    { { { 0, 2 } }, { { 2, 3 } }, { { 2, 4 } }, { { 2, 5 } },
+      { { 3, 4 } }, { { 4, 1 } }, { { 5, 2 } }, { { 5, 4 } } }
+  };
+
+  size_t edge_index = 0;
+  for (const auto &i : edges)
+    boost::add_edge(i[0], i[1], edge_index++, g);
+
+  vector<vector<string> > covering_paths;
+  graph::run_traversal(g, 0, 1, covering_paths,
+                       graph::Traversal::all_covering_paths);
+
+  vector<vector<string> > expected_covering_paths{
+    { { { "a", "c", "d", "e", "b" } }, { { "a", "c", "f", "e", "b" } } }
+  };
+  EXPECT_EQ(expected_covering_paths, covering_paths);
+
+  // Nothing left to cover through f, so only d
+  g[5].covers.reset();
+  covering_paths.clear();
+  graph::run_traversal(g, 0, 1, covering_paths,
+                       graph::Traversal::all_covering_paths);
+
+  expected_covering_paths = { { { "a", "c", "d", "e", "b" } } };
+  EXPECT_EQ(expected_covering_paths, covering_paths);
+
+  // Without a target to cover, this is just all simple paths
+  g[boost::graph_bundle].covers.clear();
+  covering_paths.clear();
+  graph::run_traversal(g, 0, 1, covering_paths,
+                       graph::Traversal::all_covering_paths);
+
+  expected_covering_paths = { { { "a", "c", "d", "e", "b" } },
+                              { { "a", "c", "e", "b" } },
+                              { { "a", "c", "f", "e", "b" } } };
+  EXPECT_EQ(expected_covering_paths, covering_paths);
+}
+
+TEST(Traversal, BidirectionalSimplePaths) {
+  // Source a, sink b and every edge among c through g in both directions, so
+  // there are many paths of every length
+  Graph_t g(7);
+
+  for (unsigned char i = 0; i < 7; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  size_t edge_index = 0;
+  for (unsigned i = 2; i < 7; ++i) {
+    boost::add_edge(0, i, edge_index++, g);
+    boost::add_edge(i, 1, edge_index++, g);
+    for (unsigned j = 2; j < 7; ++j)
+      if (i != j)
+        boost::add_edge(i, j, edge_index++, g);
+  }
+  boost::add_edge(0, 1, edge_index++, g);
+
+  vector<vector<string> > simple_paths;
+  graph::run_traversal(g, 0, 1, simple_paths,
+                       graph::Traversal::all_simple_paths);
+
+  vector<vector<string> > bidirectional_paths;
+  graph::run_traversal(g, 0, 1, bidirectional_paths,
+                       graph::Traversal::bidirectional_simple_paths);
+
+  // 1 + 5 + 5*4 + 5*4*3 + 5*4*3*2 + 5! paths, but in a different order
+  EXPECT_EQ(326u, bidirectional_paths.size());
+  std::sort(simple_paths.begin(), simple_paths.end());
+  std::sort(bidirectional_paths.begin(), bidirectional_paths.end());
+  EXPECT_EQ(simple_paths, bidirectional_paths);
+}
+
+TEST(Traversal, ParallelSimplePaths) {
+  // Same graph as BidirectionalSimplePaths
+  Graph_t g(7);
+
+  for (unsigned char i = 0; i < 7; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  size_t edge_index = 0;
+  for (unsigned i = 2; i < 7; ++i) {
+    boost::add_edge(0, i, edge_index++, g);
+    boost::add_edge(i, 1, edge_index++, g);
+    for (unsigned j = 2; j < 7; ++j)
+      if (i != j)
+        boost::add_edge(i, j, edge_index++, g);
+  }
+  boost::add_edge(0, 1, edge_index++, g);
+
+  vector<vector<string> > simple_paths;
+  graph::run_traversal(g, 0, 1, simple_paths,
+                       graph::Traversal::all_simple_paths);
+
+  // Splitting at any depth should give the same paths in the same order
+  concurrent::ThreadPoolSimple pool(2);
+  for (size_t depth = 0; depth < 8; ++depth) {
+    vector<vector<string> > parallel_paths;
+    graph::run_traversal(g, 0, 1, parallel_paths,
+                         graph::Traversal::all_simple_paths, pool, depth);
+    EXPECT_EQ(simple_paths, parallel_paths) << "split depth " << depth;
+  }
+}
+
+TEST(Traversal, Budgets) {
+  // Same graph as BidirectionalSimplePaths, with 326 simple paths
+  Graph_t g(7);
+
+  for (unsigned char i = 0; i < 7; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  size_t edge_index = 0;
+  for (unsigned i = 2; i < 7; ++i) {
+    boost::add_edge(0, i, edge_index++, g);
+    boost::add_edge(i, 1, edge_index++, g);
+    for (unsigned j = 2; j < 7; ++j)
+      if (i != j)
+        boost::add_edge(i, j, edge_index++, g);
+  }
+  boost::add_edge(0, 1, edge_index++, g);
+
+  vector<vector<string> > simple_paths;
+  graph::run_traversal(g, 0, 1, simple_paths,
+                       graph::Traversal::all_simple_paths);
+
+  graph::Budget budget;
+  vector<vector<string> > paths;
+  EXPECT_FALSE(graph::run_traversal(g, 0, 1, paths,
+                                    graph::Traversal::all_simple_paths,
+                                    budget));
+  EXPECT_EQ(simple_paths, paths);
+
+  // Path limit keeps the first paths found
+  budget.max_paths = 10;
+  paths.clear();
+  EXPECT_TRUE(graph::run_traversal(g, 0, 1, paths,
+                                   graph::Traversal::all_simple_paths, budget));
+  EXPECT_EQ(vector<vector<string> >(simple_paths.begin(),
+                                    simple_paths.begin() + 10),
+            paths);
+
+  paths.clear();
+  EXPECT_TRUE(graph::run_traversal(
+      g, 0, 1, paths, graph::Traversal::bidirectional_simple_paths, budget));
+  EXPECT_EQ(10u, paths.size());
+
+  budget.max_paths = 326;
+  paths.clear();
+  EXPECT_FALSE(graph::run_traversal(g, 0, 1, paths,
+                                    graph::Traversal::all_simple_paths,
+                                    budget));
+  EXPECT_EQ(simple_paths, paths);
+
+  // Edge limit
+  budget = graph::Budget();
+  budget.max_edges = 20;
+  paths.clear();
+  EXPECT_TRUE(graph::run_traversal(g, 0, 1, paths,
+                                   graph::Traversal::all_simple_paths, budget));
+  EXPECT_GT(simple_paths.size(), paths.size());
+
+  // Split traversals share a single budget
+  concurrent::ThreadPoolSimple pool(2);
+  budget = graph::Budget();
+  budget.max_paths = 10;
+  paths.clear();
+  EXPECT_TRUE(graph::run_traversal(g, 0, 1, paths,
+                                   graph::Traversal::all_simple_paths, pool, 2,
+                                   budget));
+  EXPECT_GE(10u, paths.size());
+}
+
+TEST(Traversal, StreamingP4C4) {
+  Graph_t g(6);
+
+  for (unsigned char i = 0; i < 6; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  array<array<unsigned, 2>, 8> edges{
+    { { { 0, 2 } }, { { 2, 3 } }, { { 2, 4 } }, { { 2, 5 } },
+      { { 3, 4 } }, { { 4, 1 } }, { { 5, 2 } }, { { 5, 4 } } }
+  };
+
+  size_t edge_index = 0;
+  for (const auto &i : edges)
+    boost::add_edge(i[0], i[1], edge_index++, g);
+
+  // Streaming everything gives the same paths as storing them
+  for (const auto t : { graph::Traversal::depth_first_search,
+                        graph::Traversal::all_simple_paths,
+                        graph::Traversal::all_edge_disjoint_paths,
+                        graph::Traversal::all_covering_paths,
+                        graph::Traversal::bidirectional_simple_paths }) {
+    vector<vector<string> > stored;
+    graph::run_traversal(g, 0, 1, stored, t);
+
+    vector<vector<string> > streamed;
+    graph::PathVisitor visitor;
+    visitor.found = [&g, &streamed](const vector<graph::Vertex_t> &path) {
+      streamed.emplace_back();
+      for (const auto v : path)
+        streamed.back().push_back(g[v].name);
+      return graph::Visit::proceed;
+    };
+    EXPECT_FALSE(graph::run_traversal(g, 0, 1, visitor, t));
+    EXPECT_EQ(stored, streamed) << t;
+  }
+
+  // Skipping f leaves the paths avoiding it
+  vector<vector<graph::Vertex_t> > found;
+  graph::PathVisitor visitor;
+  visitor.extend = [](const vector<graph::Vertex_t> &branch) {
+    return branch.back() == 5 ? graph::Visit::skip : graph::Visit::proceed;
+  };
+  visitor.found = [&found](const vector<graph::Vertex_t> &path) {
+    found.push_back(path);
+    return graph::Visit::proceed;
+  };
+  EXPECT_FALSE(graph::run_traversal(g, 0, 1, visitor,
+                                    graph::Traversal::all_edge_disjoint_paths));
+  vector<vector<graph::Vertex_t> > expected{ { 0, 2, 3, 4, 1 },
+                                            { 0, 2, 4, 1 } };
+  EXPECT_EQ(expected, found);
+
+  // Stopping at the first path
+  found.clear();
+  visitor.extend = nullptr;
+  visitor.found = [&found](const vector<graph::Vertex_t> &path) {
+    found.push_back(path);
+    return graph::Visit::stop;
+  };
+  EXPECT_TRUE(graph::run_traversal(g, 0, 1, visitor,
+                                   graph::Traversal::all_simple_paths));
+  EXPECT_EQ(1u, found.size());
+}
+
+TEST(Traversal, BestFirstPaths) {
+  // a is the source and b the sink. Entering c costs 2, and entering anything
+  // else costs 1
+  Graph_t g(4);
+
+  for (unsigned char i = 0; i < 4; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  array<array<unsigned, 2>, 5> edges{
+    { { { 0, 2 } }, { { 0, 3 } }, { { 2, 1 } }, { { 2, 3 } }, { { 3, 1 } } }
+  };
+
+  size_t edge_index = 0;
+  for (const auto &i : edges)
+    boost::add_edge(i[0], i[1], edge_index++, g);
+
+  auto score = [](const vector<graph::Vertex_t> &, graph::Vertex_t next) {
+    return next == 2 ? -2.0 : -1.0;
+  };
+
+  vector<vector<string> > paths;
+  vector<double> scores;
+  EXPECT_FALSE(graph::best_first_paths(g, 0, 1, score, 0, paths, &scores));
+
+  vector<vector<string> > expected_paths{ { { { "a", "d", "b" } },
+                                            { { "a", "c", "b" } },
+                                            { { "a", "c", "d", "b" } } } };
+  EXPECT_EQ(expected_paths, paths);
+  vector<double> expected_scores{ { -2, -3, -4 } };
+  EXPECT_EQ(expected_scores, scores);
+
+  // Only the best two
+  paths.clear();
+  EXPECT_FALSE(graph::best_first_paths(g, 0, 1, score, 2, paths));
+  expected_paths.pop_back();
+  EXPECT_EQ(expected_paths, paths);
+
+  // Out of budget before the second
+  graph::Budget budget;
+  budget.max_paths = 1;
+  paths.clear();
+  EXPECT_TRUE(
+      graph::best_first_paths(g, 0, 1, score, 2, paths, nullptr, budget));
+  expected_paths.pop_back();
+  EXPECT_EQ(expected_paths, paths);
+}
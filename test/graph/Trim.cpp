@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+using std::array;
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include "graph/Graph.h"
+using graph::Graph_t;
+#include "graph/Traversals.h"
+#include "graph/Trim.h"
+
+TEST(Trim, DeadEnds) {
+  // a is the source and b the sink. d is a dead end off of c, e cannot be
+  // reached from a, and g can only be reached from e
+  Graph_t g(7);
+
+  for (unsigned char i = 0; i < 7; ++i)
+    g[i].name = string({ static_cast<char>('a' + i) });
+
+  array<array<unsigned, 2>, 8> edges{
+    { { { 0, 2 } }, { { 2, 3 } }, { { 2, 1 } }, { { 4, 2 } },
+      { { 0, 5 } }, { { 5, 1 } }, { { 4, 6 } }, { { 5, 2 } } }
+  };
+
+  size_t edge_index = 0;
+  for (const auto &i : edges)
+    boost::add_edge(i[0], i[1], edge_index++, g);
+
+  vector<vector<string> > before;
+  graph::run_traversal(g, 0, 1, before, graph::Traversal::all_simple_paths);
+
+  EXPECT_EQ(3u, graph::trim(g, 0, 1));
+
+  ASSERT_EQ(4u, num_vertices(g));
+  vector<string> names;
+  for (unsigned i = 0; i < num_vertices(g); ++i)
+    names.push_back(g[i].name);
+  vector<string> expected_names{ "a", "b", "c", "f" };
+  EXPECT_EQ(expected_names, names);
+
+  // Only edges between surviving vertices remain, indexed from 0
+  EXPECT_EQ(5u, num_edges(g));
+  vector<size_t> indices;
+  boost::graph_traits<Graph_t>::edge_iterator ei, ei_end;
+  for (boost::tie(ei, ei_end) = boost::edges(g); ei != ei_end; ++ei)
+    indices.push_back(get(boost::edge_index, g, *ei));
+  std::sort(indices.begin(), indices.end());
+  vector<size_t> expected_indices{ 0, 1, 2, 3, 4 };
+  EXPECT_EQ(expected_indices, indices);
+
+  // Trimming doesn't change which paths are found
+  vector<vector<string> > after;
+  graph::run_traversal(g, 0, 1, after, graph::Traversal::all_simple_paths);
+  EXPECT_EQ(before, after);
+
+  // Nothing left to trim
+  EXPECT_EQ(0u, graph::trim(g, 0, 1));
+}
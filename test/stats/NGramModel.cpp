@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+using std::log;
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+using std::stringstream;
+#include <string>
+using std::string;
+
+#include "stats/NGramModel.h"
+
+TEST(NGramModel, Bigrams) {
+  // Three symbols counting the sentinel, each seen once more than counted
+  stats::NGramModel model(2, "ab");
+  model.add("ab");
+  model.add("abb");
+
+  EXPECT_DOUBLE_EQ(log(3.0 / 5), model.log_probability("", 'a'));
+  EXPECT_DOUBLE_EQ(log(1.0 / 5), model.log_probability("", 'b'));
+  EXPECT_DOUBLE_EQ(log(3.0 / 5), model.log_probability("a", 'b'));
+  EXPECT_DOUBLE_EQ(log(2.0 / 6), model.log_probability("ab", 'b'));
+  EXPECT_DOUBLE_EQ(log(3.0 / 6), model.log_probability_end("ab"));
+
+  // Unknown characters are never seen
+  EXPECT_DOUBLE_EQ(log(1.0 / 5), model.log_probability("a", 'z'));
+
+  EXPECT_DOUBLE_EQ(log(3.0 / 5) + log(3.0 / 5) + log(3.0 / 6),
+                   model.log_probability("ab"));
+  EXPECT_GT(model.log_probability("ab"), model.log_probability("ba"));
+}
+
+TEST(NGramModel, ReadWrite) {
+  stats::NGramModel model(3, "abc", 0.5);
+  model.add("abcab");
+  model.add("cab");
+
+  stringstream file;
+  model.write(file);
+
+  stats::NGramModel loaded;
+  ASSERT_TRUE(loaded.read(file));
+  EXPECT_EQ(3u, loaded.order());
+  EXPECT_EQ("abc", loaded.alphabet());
+  for (const string word : { "", "a", "cab", "abcab", "bbb" })
+    EXPECT_DOUBLE_EQ(model.log_probability(word), loaded.log_probability(word));
+
+  // Truncated or foreign files are rejected
+  string written = file.str();
+  stringstream truncated(written.substr(0, written.size() - 1));
+  EXPECT_FALSE(loaded.read(truncated));
+  EXPECT_EQ(0u, loaded.order());
+
+  stringstream foreign("NOPE");
+  EXPECT_FALSE(loaded.read(foreign));
+
+  // As are orders too large to allocate, rather than read
+  const std::uint32_t huge = 1000;
+  string corrupt = written;
+  std::memcpy(&corrupt[4], &huge, sizeof(huge));
+  stringstream large(corrupt);
+  EXPECT_FALSE(loaded.read(large));
+}
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+using std::size_t;
+#include <random>
+using std::mt19937_64;
+#include <vector>
+using std::vector;
+
+#include "util/BitKernels.h"
+using util::BitKernel;
+using util::Word;
+
+TEST(BitKernels, AllKernelsAgree) {
+  mt19937_64 rng(7);
+  vector<Word> a(37), b(37);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = rng();
+    b[i] = rng();
+  }
+  a[3] = ~Word(0);
+  b[3] = ~Word(0);
+
+  // Reference counts a bit at a time
+  vector<size_t> expected_count(a.size() + 1, 0);
+  vector<size_t> expected_and(a.size() + 1, 0);
+  vector<size_t> expected_or(a.size() + 1, 0);
+  for (size_t n = 1; n <= a.size(); ++n) {
+    expected_count[n] = expected_count[n - 1];
+    expected_and[n] = expected_and[n - 1];
+    expected_or[n] = expected_or[n - 1];
+    for (unsigned bit = 0; bit < 64; ++bit) {
+      const Word mask = Word(1) << bit;
+      expected_count[n] += (a[n - 1] & mask) != 0;
+      expected_and[n] += (a[n - 1] & b[n - 1] & mask) != 0;
+      expected_or[n] += ((a[n - 1] | b[n - 1]) & mask) != 0;
+    }
+  }
+
+  const BitKernel original = util::bit_kernel();
+  for (const BitKernel kernel : { BitKernel::generic, BitKernel::popcnt,
+                                  BitKernel::avx2, BitKernel::avx512 }) {
+    if (!util::force_bit_kernel(kernel))
+      continue;
+    EXPECT_EQ(kernel, util::bit_kernel());
+
+    // Every length, to cover each kernel's tail handling
+    for (size_t n = 0; n <= a.size(); ++n) {
+      EXPECT_EQ(expected_count[n], util::count(a.data(), n)) << kernel << n;
+      EXPECT_EQ(expected_and[n], util::count_and(a.data(), b.data(), n))
+          << kernel << n;
+      EXPECT_EQ(expected_or[n], util::count_or(a.data(), b.data(), n))
+          << kernel << n;
+    }
+  }
+  EXPECT_TRUE(util::force_bit_kernel(original));
+}
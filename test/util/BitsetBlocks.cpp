@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+// Copyright 2017 Will Mitchell
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+using std::back_inserter;
+#include <vector>
+using std::vector;
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "util/BitKernels.h"
+#include "util/BitsetBlocks.h"
+using util::BitsetBlocks;
+
+TEST(BitsetBlocks, MatchesBlockRange) {
+  boost::dynamic_bitset<> bits(200);
+  bits.set(0).set(63).set(64).set(130).set(199);
+
+  vector<util::Word> expected;
+  boost::to_block_range(bits, back_inserter(expected));
+
+  const BitsetBlocks words = util::blocks(bits);
+  ASSERT_EQ(expected.size(), words.size);
+  EXPECT_EQ(expected, vector<util::Word>(words.data, words.data + words.size));
+  EXPECT_EQ(5u, util::count(words.data, words.size));
+
+  // Copies of the words stay valid as long as the bitset
+  const BitsetBlocks copied = words;
+  EXPECT_EQ(words.data, copied.data);
+  EXPECT_EQ(bits, util::as_dynamic_bitset(bits));
+}